@@ -0,0 +1,79 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "DamageAggregatorComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/GameStateBase.h"
+#include "MeatRealm.h"
+#include "HeroCharacter.h"
+
+DECLARE_CYCLE_STAT(TEXT("Damage Flush"), STAT_DamageFlush, STATGROUP_MeatRealm);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Damage Hits"), STAT_DamageHits, STATGROUP_MeatRealm);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Damage Hits Resolved"), STAT_DamageHitsResolved, STATGROUP_MeatRealm);
+
+UDamageAggregatorComponent::UDamageAggregatorComponent()
+{
+	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.bStartWithTickEnabled = false;
+
+	// After projectiles, hitscan and overlaps have all had their go
+	PrimaryComponentTick.TickGroup = TG_PostUpdateWork;
+}
+
+UDamageAggregatorComponent* UDamageAggregatorComponent::Get(const UWorld* World)
+{
+	if (!World) return nullptr;
+
+	const auto GameState = World->GetGameState();
+	return GameState ? GameState->FindComponentByClass<UDamageAggregatorComponent>() : nullptr;
+}
+
+void UDamageAggregatorComponent::Add(AHeroCharacter* Victim, uint32 AttackerId, float Damage, const FVector& Location)
+{
+	check(GetOwner()->HasAuthority())
+	check(Victim)
+	INC_DWORD_STAT(STAT_DamageHits);
+
+	auto Existing = Pending.FindByPredicate([Victim, AttackerId](const FPendingDamage& P)
+	{
+		return P.Victim == Victim && P.AttackerId == AttackerId;
+	});
+
+	if (Existing)
+	{
+		Existing->Damage += Damage;
+		Existing->HitCount++;
+		Existing->LocationSum += Location;
+		return;
+	}
+
+	Pending.Add(FPendingDamage{ Victim, AttackerId, Damage, 1, Location });
+	SetComponentTickEnabled(true);
+}
+
+void UDamageAggregatorComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+	Flush();
+}
+
+void UDamageAggregatorComponent::Flush()
+{
+	SCOPE_CYCLE_COUNTER(STAT_DamageFlush);
+
+	// Resolving can kill, respawn and so on. Anything that lands meanwhile waits for the next flush.
+	TArray<FPendingDamage> ToResolve = MoveTemp(Pending);
+	Pending.Reset();
+
+	for (const auto& P : ToResolve)
+	{
+		// Already killed by an earlier attacker this frame
+		auto Victim = P.Victim.Get();
+		if (!Victim || Victim->IsPendingKillPending()) continue;
+
+		Victim->AuthResolveDamage(P.AttackerId, P.Damage, P.HitCount, P.LocationSum / P.HitCount);
+		INC_DWORD_STAT(STAT_DamageHitsResolved);
+	}
+
+	if (Pending.Num() == 0) SetComponentTickEnabled(false);
+}
@@ -0,0 +1,46 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+
+#include "DamageAggregatorComponent.generated.h"
+
+class AHeroCharacter;
+
+/**
+ * Gathers up every hit landed in a frame and applies them per attacker and victim at the end of it, so a
+ * shotgun blast is one hit with one set of notifications rather than eight. [Server]
+ */
+UCLASS(ClassGroup = (Custom))
+class MEATREALM_API UDamageAggregatorComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+private:
+	struct FPendingDamage
+	{
+		TWeakObjectPtr<AHeroCharacter> Victim;
+		uint32 AttackerId;
+		float Damage;
+		int32 HitCount;
+		FVector LocationSum;
+	};
+
+	// In the order the first hit of each pair landed. Only a handful a frame.
+	TArray<FPendingDamage> Pending;
+
+
+public:
+	UDamageAggregatorComponent();
+	static UDamageAggregatorComponent* Get(const UWorld* World);
+
+	void Add(AHeroCharacter* Victim, uint32 AttackerId, float Damage, const FVector& Location);
+
+protected:
+	void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+private:
+	void Flush();
+};
@@ -10,6 +10,7 @@
 class UWidgetComponent;
 class USceneComponent;
 
+// No longer spawned, see UDamageNumberComponent. Kept so existing blueprints still load.
 UCLASS()
 class MEATREALM_API ADamageNumber : public AActor
 {
@@ -0,0 +1,88 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "DamageNumberComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "Styling/CoreStyle.h"
+#include "MeatRealm.h"
+#include "DamageNumberLayer.h"
+#include "Structs/DmgHitResult.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Damage Numbers Merged"), STAT_DamageNumbersMerged, STATGROUP_MeatRealm);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Damage Numbers Evicted"), STAT_DamageNumbersEvicted, STATGROUP_MeatRealm);
+
+UDamageNumberComponent::UDamageNumberComponent()
+{
+	PrimaryComponentTick.bCanEverTick = false;
+
+	Font = FCoreStyle::GetDefaultFontStyle("Bold", 18);
+}
+
+void UDamageNumberComponent::AddHit(const FMRHitResult& Hit)
+{
+	if (!Layer) CreateLayer();
+
+	const float Now = GetWorld()->GetTimeSeconds();
+
+	// Add to a recent number on the same target. Oldest slot goes otherwise, free ones are oldest of all.
+	int32 Oldest = 0;
+	for (int32 i = 0; i < Numbers.Num(); ++i)
+	{
+		auto& Number = Numbers[i];
+
+		if (Number.SpawnTime >= 0 &&
+			Number.TargetId == Hit.ReceiverControllerId &&
+			Number.bHitArmour == Hit.bHitArmour &&
+			Now - Number.SpawnTime <= MergeWindow)
+		{
+			Number.Damage += Hit.DamageTaken;
+			Number.Text = FString::FromInt(Number.Damage);
+			Number.Location = Hit.HitLocation;
+			Number.SpawnTime = Now;
+			INC_DWORD_STAT(STAT_DamageNumbersMerged);
+			return;
+		}
+
+		if (Number.SpawnTime < Numbers[Oldest].SpawnTime) Oldest = i;
+	}
+
+	auto& Number = Numbers[Oldest];
+	if (Number.SpawnTime >= 0 && Now - Number.SpawnTime < Lifetime)
+	{
+		INC_DWORD_STAT(STAT_DamageNumbersEvicted);
+	}
+
+	Number.Location = Hit.HitLocation;
+	Number.TargetId = Hit.ReceiverControllerId;
+	Number.Damage = Hit.DamageTaken;
+	Number.Text = FString::FromInt(Hit.DamageTaken);
+	Number.bHitArmour = Hit.bHitArmour;
+	Number.SpawnTime = Now;
+}
+
+void UDamageNumberComponent::CreateLayer()
+{
+	Numbers.SetNum(FMath::Max(MaxNumbers, 1));
+
+	const auto PC = Cast<APlayerController>(GetOwner());
+	if (!PC) return;
+
+	Layer = CreateWidget<UDamageNumberLayer>(PC, UDamageNumberLayer::StaticClass());
+	if (Layer)
+	{
+		Layer->SetSource(this);
+		Layer->AddToViewport(-1); // Under the HUD
+	}
+}
+
+void UDamageNumberComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (Layer)
+	{
+		Layer->RemoveFromParent();
+		Layer = nullptr;
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
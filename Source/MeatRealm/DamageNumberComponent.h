@@ -0,0 +1,84 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "Fonts/SlateFontInfo.h"
+
+#include "DamageNumberComponent.generated.h"
+
+class UDamageNumberLayer;
+struct FMRHitResult;
+
+struct FDamageNumber
+{
+	FVector Location = FVector::ZeroVector;
+	FString Text;
+	uint32 TargetId = 0;
+	int Damage = 0;
+	bool bHitArmour = false;
+
+	// World time of the latest hit merged in. Negative when the slot is free.
+	float SpawnTime = -1;
+};
+
+/**
+ * Damage numbers for the hits the local player lands. A fixed pool of entries all drawn by one widget layer, hits on
+ * the same target close together add up into one number, and when the pool is full the oldest number makes way.
+ */
+UCLASS(ClassGroup = (Custom))
+class MEATREALM_API UDamageNumberComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	// Hard cap on numbers on screen
+	UPROPERTY(EditDefaultsOnly, Category = "Damage Numbers")
+		int32 MaxNumbers = 24;
+
+	UPROPERTY(EditDefaultsOnly, Category = "Damage Numbers")
+		float Lifetime = 3.f;
+
+	// Hits on the same target closer together than this add to the same number
+	UPROPERTY(EditDefaultsOnly, Category = "Damage Numbers")
+		float MergeWindow = 0.4f;
+
+	// Fades out over the end of its life
+	UPROPERTY(EditDefaultsOnly, Category = "Damage Numbers")
+		float FadeDuration = 0.5f;
+
+	UPROPERTY(EditDefaultsOnly, Category = "Damage Numbers")
+		float RiseSpeed = 40.f; // px/s
+
+	UPROPERTY(EditDefaultsOnly, Category = "Damage Numbers")
+		FSlateFontInfo Font;
+
+	UPROPERTY(EditDefaultsOnly, Category = "Damage Numbers")
+		FLinearColor HealthColor = FLinearColor::White;
+
+	UPROPERTY(EditDefaultsOnly, Category = "Damage Numbers")
+		FLinearColor ArmourColor = FLinearColor{ 0.2f, 0.5f, 1.f };
+
+private:
+	// Sized once to MaxNumbers then only ever overwritten
+	TArray<FDamageNumber> Numbers;
+
+	UPROPERTY()
+		UDamageNumberLayer* Layer = nullptr;
+
+
+public:
+	UDamageNumberComponent();
+
+	// Local player only
+	void AddHit(const FMRHitResult& Hit);
+
+	const TArray<FDamageNumber>& GetNumbers() const { return Numbers; }
+
+protected:
+	void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+private:
+	void CreateLayer();
+};
@@ -0,0 +1,65 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "DamageNumberLayer.h"
+#include "Engine/World.h"
+#include "Blueprint/WidgetLayoutLibrary.h"
+#include "Framework/Application/SlateApplication.h"
+#include "Fonts/FontMeasure.h"
+#include "Rendering/DrawElements.h"
+#include "MeatRealm.h"
+#include "DamageNumberComponent.h"
+
+DECLARE_CYCLE_STAT(TEXT("Damage Numbers Paint"), STAT_DamageNumbersPaint, STATGROUP_MeatRealm);
+
+void UDamageNumberLayer::NativeConstruct()
+{
+	Super::NativeConstruct();
+	SetVisibility(ESlateVisibility::HitTestInvisible);
+}
+
+int32 UDamageNumberLayer::NativePaint(const FPaintArgs& Args, const FGeometry& AllottedGeometry, const FSlateRect& MyCullingRect,
+	FSlateWindowElementList& OutDrawElements, int32 LayerId, const FWidgetStyle& InWidgetStyle, bool bParentEnabled) const
+{
+	LayerId = Super::NativePaint(Args, AllottedGeometry, MyCullingRect, OutDrawElements, LayerId, InWidgetStyle, bParentEnabled);
+	SCOPE_CYCLE_COUNTER(STAT_DamageNumbersPaint);
+
+	const auto Comp = Source.Get();
+	const auto PC = GetOwningPlayer();
+	if (!Comp || !PC) return LayerId;
+
+	const auto FontMeasure = FSlateApplication::Get().GetRenderer()->GetFontMeasureService();
+	const float Now = GetWorld()->GetTimeSeconds();
+
+	for (const auto& Number : Comp->GetNumbers())
+	{
+		const float Age = Now - Number.SpawnTime;
+		if (Number.SpawnTime < 0 || Age >= Comp->Lifetime) continue;
+
+		FVector2D Position;
+		if (!UWidgetLayoutLibrary::ProjectWorldLocationToWidgetPosition(PC, Number.Location, Position)) continue;
+
+		// Centred over the hit and drifting up
+		const FVector2D Size = FontMeasure->Measure(Number.Text, Comp->Font);
+		Position -= Size / 2;
+		Position.Y -= Age * Comp->RiseSpeed;
+
+		auto Color = Number.bHitArmour ? Comp->ArmourColor : Comp->HealthColor;
+		const float Remaining = Comp->Lifetime - Age;
+		if (Comp->FadeDuration > 0 && Remaining < Comp->FadeDuration)
+		{
+			Color.A *= Remaining / Comp->FadeDuration;
+		}
+
+		FSlateDrawElement::MakeText(
+			OutDrawElements,
+			LayerId + 1,
+			AllottedGeometry.ToPaintGeometry(Position, Size),
+			Number.Text,
+			Comp->Font,
+			ESlateDrawEffect::None,
+			Color * InWidgetStyle.GetColorAndOpacityTint());
+	}
+
+	return LayerId + 1;
+}
@@ -0,0 +1,30 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Blueprint/UserWidget.h"
+
+#include "DamageNumberLayer.generated.h"
+
+class UDamageNumberComponent;
+
+/**
+ * Full screen, hit test invisible layer that paints every live damage number in one pass
+ */
+UCLASS()
+class MEATREALM_API UDamageNumberLayer : public UUserWidget
+{
+	GENERATED_BODY()
+
+private:
+	TWeakObjectPtr<UDamageNumberComponent> Source;
+
+public:
+	void SetSource(UDamageNumberComponent* InSource) { Source = InSource; }
+
+protected:
+	void NativeConstruct() override;
+	int32 NativePaint(const FPaintArgs& Args, const FGeometry& AllottedGeometry, const FSlateRect& MyCullingRect,
+		FSlateWindowElementList& OutDrawElements, int32 LayerId, const FWidgetStyle& InWidgetStyle, bool bParentEnabled) const override;
+};
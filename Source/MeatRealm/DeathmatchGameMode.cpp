@@ -13,6 +13,7 @@
 #include "TimerManager.h"
 #include "Engine/Engine.h"
 #include "PickupSpawnLocation.h"
+#include "SpawnSelectionComponent.h"
 
 ADeathmatchGameMode::ADeathmatchGameMode()
 {
@@ -55,7 +56,7 @@ void ADeathmatchGameMode::Logout(AController* Exiting)
 	const auto Hero = Cast<AHeroController>(Exiting);
 
 	ConnectedHeroControllers.Remove(Hero->PlayerState->PlayerId);
-	Hero->GetHeroPlayerState()->HasLeftTheGame = true; // not using bIsInactive as it never replicates!
+	Hero->GetHeroPlayerState()->AuthSetHasLeftTheGame(); // not using bIsInactive as it never replicates!
 
 	UE_LOG(LogTemp, Warning, TEXT("ConnectedHeroControllers: %d"), ConnectedHeroControllers.Num());
 
@@ -93,57 +94,25 @@ void ADeathmatchGameMode::SetPlayerDefaults(APawn* PlayerPawn)
 	HChar->SetTint(PlayerTints[TintNumber]);
 }
 
-AActor* ADeathmatchGameMode::FindFurthestPlayerStart(AController* Controller)
+AActor* ADeathmatchGameMode::FindSafestPlayerStart(AController* Controller)
 {
-	//UE_LOG(LogTemp, Warning, TEXT("ADeathmatchGameMode::FindFurthestPlayerStart"));
+	//UE_LOG(LogTemp, Warning, TEXT("ADeathmatchGameMode::FindSafestPlayerStart"));
 
-	UWorld* World = GetWorld();
-	APlayerStart* FurthestSpawn = nullptr;
-	float FurthestSpawnDistanceToNearestPlayer = 0;
-
-	// O(n*m) Find the spawn furthest from the players
-
-	for (TActorIterator<APlayerStart> It(World); It; ++It)
-	{
-		APlayerStart* PlayerStart = *It;
-		float ClosestEnemyDist = BIG_NUMBER;
-
-		for (const TPair<uint32, AHeroController*>& pair : ConnectedHeroControllers)
-		{
-			auto HChar = Cast<AHeroCharacter>(pair.Value->GetPawn());
-			if (HChar)
-			{
-				//UE_LOG(LogTemp, Warning, TEXT("GotPawn"));
-
-				float dist = FVector::Dist(PlayerStart->GetActorLocation(), HChar->GetActorLocation());
-				if (dist < ClosestEnemyDist)
-				{
-					ClosestEnemyDist = dist;
-				}
-			}
-		}
-
-		if (ClosestEnemyDist > FurthestSpawnDistanceToNearestPlayer)
-		{
-			// Found new furthest spawn!
-			FurthestSpawn = PlayerStart;
-			FurthestSpawnDistanceToNearestPlayer = ClosestEnemyDist;
-		}
-	}
-
-	return FurthestSpawn;
+	// Threat around each start is kept up to date as heroes move, so this is cheap
+	const auto SpawnSelection = USpawnSelectionComponent::Get(GetWorld());
+	return SpawnSelection ? SpawnSelection->ChooseStart(Controller) : nullptr;
 }
 
 void ADeathmatchGameMode::RestartPlayer(AController* NewPlayer)
 {
-	// This is copy of GameModeBase's implementation with a change to spawn the furthest player start
+	// This is copy of GameModeBase's implementation with a change to spawn at the safest player start
 
 	if (NewPlayer == nullptr || NewPlayer->IsPendingKillPending())
 	{
 		return;
 	}
 
-	AActor* StartSpot = FindFurthestPlayerStart(NewPlayer);
+	AActor* StartSpot = FindSafestPlayerStart(NewPlayer);
 
 	// If a start spot wasn't found,
 	if (StartSpot == nullptr)
@@ -188,12 +157,12 @@ void ADeathmatchGameMode::OnPlayerTakeDamage(FMRHitResult Hit)
 	if (Hit.HealthRemaining <= 0)
 	{
 		// Award the killer a point
-		if (AttackerController) AttackerController->GetPlayerState<AHeroState>()->Kills++;
+		if (AttackerController) AttackerController->GetPlayerState<AHeroState>()->AuthAddKill();
 		
 		// Award death point, kill then respawn character
 		if (ReceivingController)
 		{
-			ReceivingController->GetPlayerState<AHeroState>()->Deaths++;
+			ReceivingController->GetPlayerState<AHeroState>()->AuthAddDeath();
 
 			AHeroCharacter* DeadChar = ReceivingController->GetHeroCharacter();
 			if (DeadChar)
@@ -232,12 +201,10 @@ bool ADeathmatchGameMode::ReadyToStartMatch_Implementation()
 
 bool ADeathmatchGameMode::ReadyToEndMatch_Implementation()
 {
-	// TODO OPTIMISE THIS! It's called on every tick and GetScoreboard is slow.
-
+	// Called every tick, so only reads the leader's kills which are kept up to date as kills happen
 	auto DMGameState = GetGameState<ADeathmatchGameState>();
-	auto Scores = DMGameState->GetScoreboard();
 	
-	const auto bFragLimitReached = Scores.Num() > 0 && Scores[0]->Kills >= DMGameState->FragLimit;
+	const auto bFragLimitReached = DMGameState->GetMaxKills() >= DMGameState->FragLimit;
 	return bFragLimitReached;
 }
 
@@ -60,7 +60,7 @@ public:
 	void PostLogin(APlayerController* NewPlayer) override;
 	void Logout(AController* Exiting) override;
 	bool ShouldSpawnAtStartSpot(AController* Player) override;
-	AActor* FindFurthestPlayerStart(AController* Controller);
+	AActor* FindSafestPlayerStart(AController* Controller);
 	void OnPlayerTakeDamage(FMRHitResult Hit);
 
 
@@ -5,105 +5,150 @@
 #include "HeroState.h"
 #include "ScoreboardEntryData.h"
 #include "UnrealNetwork.h"
-#include "Engine/ActorChannel.h"
 #include "Engine/World.h"
-#include "TimerManager.h"
-#include "KillfeedEntryData.h"
+#include "GameplayClock.h"
+#include "LagCompensationComponent.h"
+#include "InteractableRegistryComponent.h"
+#include "DamageAggregatorComponent.h"
+#include "SpawnSelectionComponent.h"
+#include "ProjectileManagerComponent.h"
+#include "ProjectilePoolComponent.h"
+#include "MeatyCharacterMovementComponent.h"
+#include "UObjectIterator.h"
+
+ADeathmatchGameState::ADeathmatchGameState()
+{
+	ProjectilePoolComp = CreateDefaultSubobject<UProjectilePoolComponent>(TEXT("ProjectilePoolComp"));
+	ProjectileManagerComp = CreateDefaultSubobject<UProjectileManagerComponent>(TEXT("ProjectileManagerComp"));
+	LagCompensationComp = CreateDefaultSubobject<ULagCompensationComponent>(TEXT("LagCompensationComp"));
+	TimedActionComp = CreateDefaultSubobject<UTimedActionComponent>(TEXT("TimedActionComp"));
+	InteractableRegistryComp = CreateDefaultSubobject<UInteractableRegistryComponent>(TEXT("InteractableRegistryComp"));
+	DamageAggregatorComp = CreateDefaultSubobject<UDamageAggregatorComponent>(TEXT("DamageAggregatorComp"));
+	SpawnSelectionComp = CreateDefaultSubobject<USpawnSelectionComponent>(TEXT("SpawnSelectionComp"));
+}
 
 void ADeathmatchGameState::GetLifetimeReplicatedProps(TArray< FLifetimeProperty >& OutLifetimeProps) const
 {
 	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
-	DOREPLIFETIME(ADeathmatchGameState, KillfeedData);
+	DOREPLIFETIME(ADeathmatchGameState, Killfeed);
+	DOREPLIFETIME(ADeathmatchGameState, bUseTopDownMovement);
 }
 
-bool ADeathmatchGameState::ReplicateSubobjects(UActorChannel* Channel, FOutBunch* Bunch, FReplicationFlags* RepFlags)
+void ADeathmatchGameState::PostInitializeComponents()
 {
-	bool WroteSomething = Super::ReplicateSubobjects(Channel, Bunch, RepFlags);
+	Super::PostInitializeComponents();
+
+	// Not in the constructor, the CDO's copy would point at the CDO
+	Killfeed.Owner = this;
+}
 
-	for (auto* Item : KillfeedData)
+static bool RanksAbove(const UScoreboardEntryData& A, const UScoreboardEntryData& B)
+{
+	if (A.Kills == B.Kills)
 	{
-		if (Item != nullptr)
-		{
-			WroteSomething |= Channel->ReplicateSubobject(Item, *Bunch, *RepFlags);
-		}
+		return A.Deaths < B.Deaths;
 	}
 
-	return WroteSomething;
+	return A.Kills > B.Kills;
 }
 
 TArray<UScoreboardEntryData*> ADeathmatchGameState::GetScoreboard()
 {
-	TArray<UScoreboardEntryData*> Scoreboard{};
+	if (bScoreboardNeedsRebuild) RebuildScoreboard();
 
-	for (APlayerState* PlayerState : PlayerArray)
+	// Ping changes all the time without telling anyone, and doesn't affect the order
+	for (auto Item : Scoreboard)
 	{
-		const auto Hero = Cast<AHeroState>(PlayerState);
-		if (Hero->HasLeftTheGame)
-		{
-			//UE_LOG(LogTemp, Warning, TEXT("Player %s is inactive and excluded from the scoreboard."), *PlayerState->GetPlayerName());
-			continue; // Player has left the game? // TODO Check for spectators?
-		}
+		const auto Hero = Item->Hero.Get();
+		if (Hero) Item->Ping = Hero->Ping;
+	}
 
-		UScoreboardEntryData* Item = NewObject<UScoreboardEntryData>();
-		Item->Name = Hero->GetPlayerName();
-		Item->Kills = Hero->Kills;
-		Item->Deaths = Hero->Deaths;
-		Item->Ping = Hero->Ping;
+	return Scoreboard;
+}
 
-		Scoreboard.Add(Item);
+void ADeathmatchGameState::NotifyScoreChanged(AHeroState* Hero)
+{
+	if (!Hero->HasLeftTheGame) MaxKills = FMath::Max(MaxKills, Hero->Kills);
+	if (bScoreboardNeedsRebuild) return;
+
+	const int32 Index = Scoreboard.IndexOfByPredicate([Hero](const UScoreboardEntryData* Item) { return Item->Hero == Hero; });
+	if (Index == INDEX_NONE)
+	{
+		bScoreboardNeedsRebuild = true;
+		return;
 	}
 
-	Scoreboard.Sort([](const UScoreboardEntryData & A, const UScoreboardEntryData & B)
-		{
-			if (A.Kills == B.Kills)
-			{
-				return A.Deaths < B.Deaths;
-			}
-			
-			return A.Kills > B.Kills;
-		});
+	// Only this one moved, so step it into place rather than sorting everyone
+	const auto Item = Scoreboard[Index];
+	Item->Kills = Hero->Kills;
+	Item->Deaths = Hero->Deaths;
 
-	return std::move(Scoreboard);
+	int32 i = Index;
+	while (i > 0 && RanksAbove(*Item, *Scoreboard[i - 1]))
+	{
+		Scoreboard[i] = Scoreboard[i - 1];
+		--i;
+	}
+	while (i < Scoreboard.Num() - 1 && RanksAbove(*Scoreboard[i + 1], *Item))
+	{
+		Scoreboard[i] = Scoreboard[i + 1];
+		++i;
+	}
+	Scoreboard[i] = Item;
 }
 
-void ADeathmatchGameState::StartARemoveKillfeedItemTimer()
+void ADeathmatchGameState::NotifyPlayersChanged()
 {
-	// Create a timer
-	FTimerHandle Handle;
+	bScoreboardNeedsRebuild = true;
 
-	UWorld* World = GetWorld();
-	if (World)
+	// Rare enough to just recount. The leader may have left.
+	MaxKills = 0;
+	for (APlayerState* PlayerState : PlayerArray)
 	{
-		World->GetTimerManager().SetTimer(
-			Handle, this, &ADeathmatchGameState::FinishOldestKillfeedItemTimer, KillfeedItemDuration, false, -1);
-		
-		Timers.Add(Handle);
+		const auto Hero = Cast<AHeroState>(PlayerState);
+		if (Hero && !Hero->HasLeftTheGame) MaxKills = FMath::Max(MaxKills, Hero->Kills);
 	}
 }
 
-void ADeathmatchGameState::FinishOldestKillfeedItemTimer()
+void ADeathmatchGameState::AddPlayerState(APlayerState* PlayerState)
 {
-	if (Timers.Num() == 0) 
-		UE_LOG(LogTemp, Error, TEXT("Attempted to move a timer but there aren't any!"));
+	Super::AddPlayerState(PlayerState);
+	NotifyPlayersChanged();
+}
 
-	if (KillfeedData.Num() == 0) 
-		UE_LOG(LogTemp, Error, TEXT("Attempted to move a timer but there aren't any!"));
+void ADeathmatchGameState::RemovePlayerState(APlayerState* PlayerState)
+{
+	Super::RemovePlayerState(PlayerState);
+	NotifyPlayersChanged();
+}
 
-	auto FirstTimer = Timers[0];
-	Timers.RemoveAt(0);
-	KillfeedData.RemoveAt(0);
+void ADeathmatchGameState::RebuildScoreboard()
+{
+	bScoreboardNeedsRebuild = false;
 
-	UWorld* World = GetWorld();
-	if (FirstTimer.IsValid() && World)
-	{
-		World->GetTimerManager().ClearTimer(FirstTimer);
-	}
-	
-	// Make sure a listen server knows about this
-	if (GetNetMode() != NM_DedicatedServer)
+	int32 Count = 0;
+	for (APlayerState* PlayerState : PlayerArray)
 	{
-		OnRep_KillfeedDataChanged();
+		const auto Hero = Cast<AHeroState>(PlayerState);
+		if (!Hero || Hero->HasLeftTheGame)
+		{
+			//UE_LOG(LogTemp, Warning, TEXT("Player %s is inactive and excluded from the scoreboard."), *PlayerState->GetPlayerName());
+			continue; // Player has left the game? // TODO Check for spectators?
+		}
+
+		// Entries are kept and reused, new ones are only made when the game gets bigger
+		if (Count == Scoreboard.Num()) Scoreboard.Add(NewObject<UScoreboardEntryData>(this));
+
+		UScoreboardEntryData* Item = Scoreboard[Count++];
+		Item->Hero = Hero;
+		Item->Name = Hero->GetPlayerName();
+		Item->Kills = Hero->Kills;
+		Item->Deaths = Hero->Deaths;
+		Item->Ping = Hero->Ping;
 	}
+	Scoreboard.SetNum(Count);
+
+	Scoreboard.Sort(RanksAbove);
 }
 
 void ADeathmatchGameState::AddKillfeedData(const FString& Victor, const FString& Verb, const FString& Dead)
@@ -112,19 +157,28 @@ void ADeathmatchGameState::AddKillfeedData(const FString& Victor, const FString&
 
 	//LogMsgWithRole("ADeathmatchGameState::AddKillfeedData()");
 
-	UKillfeedEntryData* Entry = NewObject<UKillfeedEntryData>(this);
-	Entry->Winner = Victor;
-	Entry->Verb = "killed";
-	Entry->Loser = Dead;
-	KillfeedData.Add(Entry);
+	const float Now = FGameplayClock::Now(GetWorld());
 
-	if (KillfeedData.Num() > 4)
+	// Ring buffer. Drop whatever has expired or is pushed out by this one.
+	auto& Entries = Killfeed.Entries;
+	int32 NumToDrop = 0;
+	while (NumToDrop < Entries.Num() &&
+		(Entries.Num() - NumToDrop >= KillfeedMaxItems || Entries[NumToDrop].Time + KillfeedItemDuration <= Now))
+	{
+		++NumToDrop;
+	}
+	if (NumToDrop > 0)
 	{
-		FinishOldestKillfeedItemTimer();
+		Entries.RemoveAt(0, NumToDrop, false);
+		Killfeed.MarkArrayDirty();
 	}
 
-	StartARemoveKillfeedItemTimer();
-	
+	FKillfeedEntry Entry;
+	Entry.Winner = Victor;
+	Entry.Verb = "killed";
+	Entry.Loser = Dead;
+	Entry.Time = Now;
+	Killfeed.MarkItemDirty(Entries.Add_GetRef(Entry));
 
 	// Make sure a listen server knows about this
 	if (GetNetMode() != NM_DedicatedServer)
@@ -133,21 +187,81 @@ void ADeathmatchGameState::AddKillfeedData(const FString& Victor, const FString&
 	}
 }
 
+TArray<FKillfeedEntry> ADeathmatchGameState::GetKillfeed() const
+{
+	const float Now = FGameplayClock::Now(GetWorld());
+
+	TArray<FKillfeedEntry> Visible{};
+	for (const auto& Entry : Killfeed.Entries)
+	{
+		if (Entry.Time + KillfeedItemDuration > Now) Visible.Add(Entry);
+	}
+
+	// Clients don't keep the server's order, and may briefly hold an entry the server has already pushed out
+	Visible.Sort([](const FKillfeedEntry& A, const FKillfeedEntry& B) { return A.Time < B.Time; });
+	if (Visible.Num() > KillfeedMaxItems)
+	{
+		Visible.RemoveAt(0, Visible.Num() - KillfeedMaxItems);
+	}
+	return Visible;
+}
+
 void ADeathmatchGameState::OnRep_KillfeedDataChanged()
 {
 	OnKillfeedChanged.Broadcast();
-	/*UE_LOG(LogTemp, Warning, TEXT("KILLFEED"));
-	for (UKillfeedEntryData* entry : KillfeedData)
+	ScheduleKillfeedExpiry();
+}
+
+void ADeathmatchGameState::ScheduleKillfeedExpiry()
+{
+	const auto Actions = UTimedActionComponent::Get(GetWorld());
+	if (!Actions) return;
+
+	const float Now = FGameplayClock::Now(GetWorld());
+
+	// The oldest one still showing is the next to go. Client order isn't reliable, so look at all of them.
+	const FKillfeedEntry* Next = nullptr;
+	for (const auto& Entry : Killfeed.Entries)
 	{
-		if (!entry)
-		{
-			UE_LOG(LogTemp, Warning, TEXT("  Entry is null"));
-			continue;
-		}
+		if (Entry.Time + KillfeedItemDuration <= Now) continue;
+		if (!Next || Entry.Time < Next->Time) Next = &Entry;
+	}
+
+	if (!Next)
+	{
+		Actions->Cancel(KillfeedExpiryHandle);
+		return;
+	}
+
+	FTimedAction Expiry;
+	Expiry.StartTime = Next->Time;
+	Expiry.Duration = KillfeedItemDuration;
+
+	// Entries aren't removed here, GetKillfeed() just stops returning them
+	Actions->Schedule(Expiry, this, KillfeedExpiryHandle, [this] { OnRep_KillfeedDataChanged(); });
+}
+
 
-		UE_LOG(LogTemp, Warning, TEXT("  Entry %d %s %s %s"), KillfeedData.Num(),
-			*entry->Winner, *entry->Verb, *entry->Loser);
-	}*/
+
+void ADeathmatchGameState::SetUseTopDownMovement(bool bUse)
+{
+	if (!HasAuthority()) return;
+
+	bUseTopDownMovement = bUse;
+	OnRep_UseTopDownMovement();
+}
+
+void ADeathmatchGameState::OnRep_UseTopDownMovement()
+{
+	const auto World = GetWorld();
+
+	// Heroes spawned later pick it up in their own BeginPlay
+	for (TObjectIterator<UMeatyCharacterMovementComponent> It; It; ++It)
+	{
+		if (It->GetWorld() != World || It->IsTemplate()) continue;
+
+		It->SetUseTopDownMovement(bUseTopDownMovement);
+	}
 }
 
 
@@ -4,12 +4,21 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/GameState.h"
+#include "KillfeedEntryData.h"
+#include "TimedActionComponent.h"
 
 #include "DeathmatchGameState.generated.h"
 
 
 class UScoreboardEntryData;
-class UKillfeedEntryData;
+class AHeroState;
+class UProjectilePoolComponent;
+class UProjectileManagerComponent;
+class ULagCompensationComponent;
+class UTimedActionComponent;
+class UInteractableRegistryComponent;
+class UDamageAggregatorComponent;
+class USpawnSelectionComponent;
 
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FIncomingSuper, float, Time, FString, Location);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE(FKillfeedChanged);
@@ -20,11 +29,24 @@ class MEATREALM_API ADeathmatchGameState : public AGameState
 	GENERATED_BODY()
 
 public:
-	virtual bool ReplicateSubobjects(UActorChannel* Channel, FOutBunch* Bunch, FReplicationFlags* RepFlags) override;
+	ADeathmatchGameState();
 
+	// Ranked best first. The entries are reused and only re-sorted when a score or the player list changes.
 	UFUNCTION(BlueprintCallable)
 		TArray<UScoreboardEntryData*> GetScoreboard();
 
+	// Most kills of anyone still in the game
+	int GetMaxKills() const { return MaxKills; }
+
+	// One player's score moved
+	void NotifyScoreChanged(AHeroState* Hero);
+
+	// Someone joined or left
+	void NotifyPlayersChanged();
+
+	void AddPlayerState(APlayerState* PlayerState) override;
+	void RemovePlayerState(APlayerState* PlayerState) override;
+
 	
 	void NotifyIncomingSuper(float PowerUpAnnouncementLeadTime, const FString& LocationMsg);
 
@@ -34,9 +56,6 @@ public:
 	UPROPERTY(BlueprintAssignable, Category = "Event Dispatchers")
 		FIncomingSuper OnIncomingSuper;
 
-	void StartARemoveKillfeedItemTimer();
-	void FinishOldestKillfeedItemTimer();
-
 	void AddKillfeedData(const FString& Victor, const FString& Verb, const FString& Dead);
 
 	UPROPERTY(EditAnywhere, BlueprintReadOnly)
@@ -50,18 +69,71 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadOnly)
 	float KillfeedItemDuration = 3;
 
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, ReplicatedUsing=OnRep_KillfeedDataChanged)
-		TArray<UKillfeedEntryData*> KillfeedData;
+	// Older kills are dropped past this
+	UPROPERTY(EditAnywhere, BlueprintReadOnly)
+		int KillfeedMaxItems = 4;
 
-	UFUNCTION()
-		void OnRep_KillfeedDataChanged();
+	// Kills still on screen, oldest first
+	UFUNCTION(BlueprintCallable)
+		TArray<FKillfeedEntry> GetKillfeed() const;
+
+	void OnRep_KillfeedDataChanged();
+
+	// Heroes use flat ground top down movement. Set on the server, every machine applies it so moves agree.
+	bool UseTopDownMovement() const { return bUseTopDownMovement; }
+	void SetUseTopDownMovement(bool bUse);
+
+protected:
+	void PostInitializeComponents() override;
 
 private:
 
+	UPROPERTY(VisibleAnywhere)
+		UProjectilePoolComponent* ProjectilePoolComp = nullptr;
+
+	UPROPERTY(VisibleAnywhere)
+		UProjectileManagerComponent* ProjectileManagerComp = nullptr;
+
+	UPROPERTY(VisibleAnywhere)
+		ULagCompensationComponent* LagCompensationComp = nullptr;
+
+	UPROPERTY(VisibleAnywhere)
+		UTimedActionComponent* TimedActionComp = nullptr;
+
+	UPROPERTY(VisibleAnywhere)
+		UInteractableRegistryComponent* InteractableRegistryComp = nullptr;
+
+	UPROPERTY(VisibleAnywhere)
+		UDamageAggregatorComponent* DamageAggregatorComp = nullptr;
+
+	UPROPERTY(VisibleAnywhere)
+		USpawnSelectionComponent* SpawnSelectionComp = nullptr;
+
 	UFUNCTION(NetMulticast, Reliable)
 		void MultiNotifyIncomingSuper(float PowerUpAnnouncementLeadTime, const FString& LocationMsg);
 
-	TArray<FTimerHandle> Timers{};
+	UPROPERTY(Replicated)
+		FKillfeed Killfeed;
+
+	UPROPERTY(ReplicatedUsing=OnRep_UseTopDownMovement)
+		bool bUseTopDownMovement = false;
+
+	UFUNCTION()
+		void OnRep_UseTopDownMovement();
+
+	// Ranked best first
+	UPROPERTY()
+		TArray<UScoreboardEntryData*> Scoreboard;
+
+	bool bScoreboardNeedsRebuild = true;
+	int MaxKills = 0;
+
+	void RebuildScoreboard();
+
+	// When the oldest visible kill goes. Scheduled locally on every machine, nothing is sent.
+	FTimedActionHandle KillfeedExpiryHandle;
+
+	void ScheduleKillfeedExpiry();
 
 	void LogMsgWithRole(FString message) const;
 	FString GetEnumText(ENetRole role) const;
@@ -0,0 +1,51 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "GameplayClock.h"
+#include "Engine/World.h"
+#include "GameFramework/GameStateBase.h"
+#include "Misc/App.h"
+#include "Misc/CommandLine.h"
+#include "Misc/Parse.h"
+
+float FGameplayClock::Now(const UWorld* World)
+{
+	if (!World) return 0;
+
+	const auto GameState = World->GetGameState();
+	return GameState ? GameState->GetServerWorldTimeSeconds() : World->GetTimeSeconds();
+}
+
+float FGameplayClock::LocalNow(const UWorld* World)
+{
+	return World ? World->GetTimeSeconds() : 0;
+}
+
+void FGameplayClock::SetFixedStep(float StepsPerSecond)
+{
+	if (StepsPerSecond <= 0)
+	{
+		FApp::SetUseFixedTimeStep(false);
+		UE_LOG(LogTemp, Warning, TEXT("FGameplayClock - Real time"));
+		return;
+	}
+
+	// The engine skips its frame rate limiting while this is on, so frames come as fast as they can be simulated
+	FApp::SetFixedDeltaTime(1.0 / StepsPerSecond);
+	FApp::SetUseFixedTimeStep(true);
+	UE_LOG(LogTemp, Warning, TEXT("FGameplayClock - Fixed step at %.1f steps per second"), StepsPerSecond);
+}
+
+bool FGameplayClock::IsFixedStep()
+{
+	return FApp::UseFixedTimeStep();
+}
+
+void FGameplayClock::InitFromCommandLine()
+{
+	float StepsPerSecond = 0;
+	if (FParse::Value(FCommandLine::Get(), TEXT("FixedStep="), StepsPerSecond))
+	{
+		SetFixedStep(StepsPerSecond);
+	}
+}
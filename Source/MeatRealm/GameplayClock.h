@@ -0,0 +1,30 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UWorld;
+
+/**
+ * The one clock gameplay reads. Built on world time so it follows the frame, never the wall clock.
+ *
+ * Fixed step mode advances every frame by exactly 1/StepsPerSecond no matter how long it really took, and the
+ * engine stops waiting between frames. A dedicated server with bots then plays a whole match as fast as it can,
+ * the same way every run. Start a server with -FixedStep=30, or use the FixedStep exec at runtime.
+ */
+struct MEATREALM_API FGameplayClock
+{
+	// Server world time (seconds). Clients use the replicated server clock so times mean the same on both sides.
+	static float Now(const UWorld* World);
+
+	// This machine's world time (seconds). For times that never leave it, e.g. projectile ages and lag comp samples.
+	static float LocalNow(const UWorld* World);
+
+	// 0 or less goes back to real time
+	static void SetFixedStep(float StepsPerSecond);
+	static bool IsFixedStep();
+
+	// Applies -FixedStep=<StepsPerSecond> if it's on the command line
+	static void InitFromCommandLine();
+};
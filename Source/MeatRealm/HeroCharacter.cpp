@@ -7,7 +7,6 @@
 #include "Components/ArrowComponent.h"
 #include "GameFramework/CharacterMovementComponent.h"
 #include "GameFramework/Controller.h"
-#include "GameFramework/InputSettings.h"
 #include "GameFramework/PlayerState.h"
 #include "GameFramework/SpringArmComponent.h"
 #include "Engine/Public/DrawDebugHelpers.h"
@@ -23,6 +22,13 @@
 #include "Engine/World.h"
 #include "DrawDebugHelpers.h"
 #include "Interfaces/Equippable.h"
+#include "LagCompensationComponent.h"
+#include "TimedActionComponent.h"
+#include "GameplayClock.h"
+#include "InteractionComponent.h"
+#include "InventoryComponent.h"
+#include "DamageAggregatorComponent.h"
+#include "SpawnSelectionComponent.h"
 
 /// Lifecycle
 
@@ -80,13 +86,41 @@ AHeroCharacter::AHeroCharacter(const FObjectInitializer& ObjectInitializer) : Su
 	AimPosComp = CreateDefaultSubobject<UStaticMeshComponent>(TEXT("AimPosComp"));
 	AimPosComp->SetupAttachment(RootComponent);
 
-	LastRunEnded = FDateTime::Now();
+	// Finds the pickup in reach and prompts for it
+	InteractionComp = CreateDefaultSubobject<UInteractionComponent>(TEXT("InteractionComp"));
+
+	InventoryComp = CreateDefaultSubobject<UInventoryComponent>(TEXT("InventoryComp"));
+}
+
+void AHeroCharacter::BeginPlay()
+{
+	Super::BeginPlay();
+
+	InteractionComp->SearchDistance = InteractableSearchDistance;
+	InteractionComp->SetUseGamepadPrompts(!bUseMouseAim);
+
+	// Keep a history of where we've been so shots can be resolved against what the shooter saw
+	if (HasAuthority())
+	{
+		auto LagComp = ULagCompensationComponent::Get(GetWorld());
+		if (LagComp) LagComp->Register(this, GetCapsuleComponent());
+
+		// Keep people from respawning on top of us
+		auto SpawnSelection = USpawnSelectionComponent::Get(GetWorld());
+		if (SpawnSelection) SpawnSelection->RegisterHero(this);
+	}
 }
 
 void AHeroCharacter::EndPlay(const EEndPlayReason::Type EndPlayReason)
 {
 	if (ROLE_Authority == Role)
 	{
+		auto LagComp = ULagCompensationComponent::Get(GetWorld());
+		if (LagComp) LagComp->Unregister(this);
+
+		auto SpawnSelection = USpawnSelectionComponent::Get(GetWorld());
+		if (SpawnSelection) SpawnSelection->UnregisterHero(this);
+
 		LastInventorySlot = EInventorySlots::Undefined;
 		CurrentInventorySlot = EInventorySlots::Undefined;
 		if (PrimaryWeaponSlot)
@@ -100,15 +134,7 @@ void AHeroCharacter::EndPlay(const EEndPlayReason::Type EndPlayReason)
 			SecondaryWeaponSlot = nullptr;
 		}
 
-		for (auto* HP: HealthSlot)
-		{
-			HP->Destroy();
-		}
-
-		for (auto* AP : ArmourSlot)
-		{
-			AP->Destroy();
-		}
+		InventoryComp->AuthClear();
 	}
 }
 
@@ -151,79 +177,9 @@ void AHeroCharacter::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLi
 	DOREPLIFETIME_CONDITION(AHeroCharacter, CurrentInventorySlot, COND_OwnerOnly);
 	DOREPLIFETIME_CONDITION(AHeroCharacter, PrimaryWeaponSlot, COND_OwnerOnly);
 	DOREPLIFETIME_CONDITION(AHeroCharacter, SecondaryWeaponSlot, COND_OwnerOnly);
-	DOREPLIFETIME_CONDITION(AHeroCharacter, HealthSlot, COND_OwnerOnly);
-	DOREPLIFETIME_CONDITION(AHeroCharacter, ArmourSlot, COND_OwnerOnly);
 	DOREPLIFETIME_CONDITION(AHeroCharacter, Health, COND_OwnerOnly);
 }
 
-void AHeroCharacter::ScanForWeaponPickups(float DeltaSeconds)
-{
-	auto* const Pickup = ScanForInteractable<APickupBase>();
-
-	float PickupDelay;
-	if (Pickup && Pickup->CanInteract(this, OUT PickupDelay))
-	{
-		//LogMsgWithRole(FString::Printf(TEXT("Can Interact with delay! %f "), PickupDelay));
-		auto World = GetWorld();
-
-		auto* InputSettings = UInputSettings::GetInputSettings();
-		TArray<FInputActionKeyMapping> Mappings;
-		InputSettings->GetActionMappingByName("Interact", OUT Mappings);
-
-		FString ActionText = "Undefined";
-		for (FInputActionKeyMapping Mapping : Mappings)
-		{
-			bool canUseKeyboardKey = bUseMouseAim && !Mapping.Key.IsGamepadKey();
-			bool canUseGamepadKey = !bUseMouseAim && Mapping.Key.IsGamepadKey();
-
-			if (canUseKeyboardKey)
-			{
-				ActionText = Mapping.Key.GetDisplayName().ToString();
-				break;
-			}
-
-			// Hacky! Make the gamepad text not bloody horrible
-			if (canUseGamepadKey)
-			{
-				ActionText = Mapping.Key.ToString();
-				const FString S = Mapping.Key.ToString();
-
-				if (S == "Gamepad_FaceButton_Bottom") { ActionText = "A"; break;}
-				if (S == "Gamepad_FaceButton_Right") { ActionText = "B"; break;}
-				if (S == "Gamepad_FaceButton_Left") { ActionText = "X"; break;}
-				if (S == "Gamepad_FaceButton_Top") { ActionText = "Y"; break;}
-				if (S == "Gamepad_DPad_Up") { ActionText = "Up"; break;}
-				if (S == "Gamepad_DPad_Down") { ActionText = "Down"; break;}
-				if (S == "Gamepad_DPad_Right") { ActionText = "Right"; break;}
-				if (S == "Gamepad_DPad_Left") { ActionText = "Left"; break;}
-				if (S == "Gamepad_LeftShoulder") { ActionText = "LB"; break;}
-				if (S == "Gamepad_RightShoulder") { ActionText = "RB"; break;}
-				if (S == "Gamepad_LeftTrigger") { ActionText = "LT"; break;}
-				if (S == "Gamepad_RightTrigger") { ActionText = "RT"; break;}
-				/*
-				static const FKey Gamepad_LeftThumbstick;
-				static const FKey Gamepad_RightThumbstick;
-				static const FKey Gamepad_Special_Left;
-				static const FKey Gamepad_Special_Left_X;
-				static const FKey Gamepad_Special_Left_Y;
-				static const FKey Gamepad_Special_Right;
-
-				*/
-			}
-			
-		}
-		if (World)
-		{
-			auto Str = FString::Printf(TEXT("Grab %s (%s)"), *Pickup->GetPickupName(), *ActionText);
-			const auto YOffset = -5.f * Str.Len();
-
-			DrawDebugString(World, FVector{ 50, YOffset, 100 },	Str, Pickup, FColor::White, DeltaSeconds * 0.5);
-		}
-
-		//LogMsgWithRole("Can Interact! ");
-	}
-}
-
 void AHeroCharacter::Tick(float DeltaSeconds)
 {
 	// No need for server. We're only doing input processing and client effects here.
@@ -251,8 +207,6 @@ void AHeroCharacter::Tick(float DeltaSeconds)
 		TickWalking(DeltaSeconds);
 	}
 
-	ScanForWeaponPickups(DeltaSeconds);
-
 
 	// Track camera with aim
 
@@ -474,7 +428,7 @@ void AHeroCharacter::EquipSmartHeal()
 	// Equip priority Armour, then Health, then nothing
 	auto Item = GetCurrentItem();
 
-	if (ArmourSlot.Num() > 0 && CanGiveArmour())
+	if (GetArmourItemCount() > 0 && CanGiveArmour())
 	{
 		if (Item && Item->IsAutoUseOnEquip() && Item->GetInventoryCategory() == EInventoryCategory::Armour)
 		{
@@ -485,7 +439,7 @@ void AHeroCharacter::EquipSmartHeal()
 			EquipSlot(EInventorySlots::Armour);
 		}
 	}
-	else if (HealthSlot.Num() > 0 && CanGiveHealth())
+	else if (GetHealthItemCount() > 0 && CanGiveHealth())
 	{
 		if (Item && Item->IsAutoUseOnEquip() && Item->GetInventoryCategory() == EInventoryCategory::Health)
 		{
@@ -685,47 +639,25 @@ void AHeroCharacter::SetRunning(bool bNewIsRunning)
 {
 	if (bIsRunning == bNewIsRunning) return;
 	bIsRunning = bNewIsRunning;
+
+	// Goes up to the server with our moves. Acceleration and braking follow from it in there.
+	auto Movement = Cast<UMeatyCharacterMovementComponent>(GetCharacterMovement());
+	if (Movement) Movement->SetWantsToRun(bNewIsRunning);
 	
 	RefreshWeaponAttachments();
 
 	// Do nothing if we aren't running 
 	if (bNewIsRunning)
 	{
-		// Config movement properties TODO Make these data driven (BP) and use Meaty char movement comp
-		GetCharacterMovement()->MaxAcceleration = 1250;
-		GetCharacterMovement()->BrakingFrictionFactor = 1;
-		GetCharacterMovement()->BrakingDecelerationWalking = 250;
-		
 		if (bCancelReloadOnRun && GetCurrentWeapon()) GetCurrentWeapon()->CancelAnyReload();
 	}
 	else // Is Walking 
 	{
-		// Config movement properties TODO Make these data driven (BP) and use Meaty char movement comp
-		GetCharacterMovement()->MaxAcceleration = 3000;
-		GetCharacterMovement()->BrakingFrictionFactor = 2;
-		GetCharacterMovement()->BrakingDecelerationWalking = 3000;
-
-		LastRunEnded = FDateTime::Now();
-	}
-
-	
-
-	if (Role < ROLE_Authority)
-	{
-		ServerSetRunning(bNewIsRunning);
+		RunCooldownAction.StartTime = FGameplayClock::Now(GetWorld());
+		RunCooldownAction.Duration = RunCooldown;
 	}
 }
 
-void AHeroCharacter::ServerSetRunning_Implementation(bool bNewWantsToRun)
-{
-	SetRunning(bNewWantsToRun);
-}
-
-bool AHeroCharacter::ServerSetRunning_Validate(bool bNewWantsToRun)
-{
-	return true;
-}
-
 
 
 
@@ -739,20 +671,19 @@ void AHeroCharacter::SetTargeting(bool bNewTargeting)
 {
 	bIsTargeting = bNewTargeting;
 
+	auto Movement = Cast<UMeatyCharacterMovementComponent>(GetCharacterMovement());
+	if (Movement) Movement->SetWantsToTarget(bNewTargeting);
 
 
 	if (GetCurrentWeapon())
 	{
 		if (bNewTargeting)
 		{
-			const FTimespan TimeSinceRun = FDateTime::Now() - LastRunEnded;
-			const FTimespan RemainingTime = FTimespan::FromSeconds(RunCooldown) - TimeSinceRun;
-			
-			
-			if (RemainingTime > 0)
+			const auto Actions = UTimedActionComponent::Get(GetWorld());
+			if (Actions && RunCooldownAction.IsActiveAt(FGameplayClock::Now(GetWorld())))
 			{
 				// Delay fire!
-				auto DelayAds = [&]
+				auto DelayAds = [this]
 				{
 					if (bIsTargeting && GetCurrentWeapon())
 					{
@@ -760,7 +691,7 @@ void AHeroCharacter::SetTargeting(bool bNewTargeting)
 					}
 				};
 
-				GetWorld()->GetTimerManager().SetTimer(RunEndTimerHandle, DelayAds, RemainingTime.GetTotalSeconds(), false);
+				Actions->Schedule(RunCooldownAction, this, RunEndAction, DelayAds);
 			}
 			else
 			{
@@ -778,22 +709,6 @@ void AHeroCharacter::SetTargeting(bool bNewTargeting)
 	//{
 	//	UGameplayStatics::SpawnSoundAttached(TargetingSound, GetRootComponent());
 	//}
-
-
-	if (Role < ROLE_Authority)
-	{
-		ServerSetTargeting(bNewTargeting);
-	}
-}
-
-bool AHeroCharacter::ServerSetTargeting_Validate(bool bNewTargeting)
-{
-	return true;
-}
-
-void AHeroCharacter::ServerSetTargeting_Implementation(bool bNewTargeting)
-{
-	SetTargeting(bNewTargeting);
 }
 
 //void AHeroCharacter::DrawAdsLine(const FColor& Color, float LineLength) const
@@ -900,12 +815,11 @@ void AHeroCharacter::StartWeaponFire()
 		bWantsToFire = true;
 
 
-		const FTimespan TimeSinceRun = FDateTime::Now() - LastRunEnded;
-		const FTimespan RemainingTime = FTimespan::FromSeconds(RunCooldown) - TimeSinceRun;
-		if (RemainingTime > 0)
+		const auto Actions = UTimedActionComponent::Get(GetWorld());
+		if (Actions && RunCooldownAction.IsActiveAt(FGameplayClock::Now(GetWorld())))
 		{
 			// Delay fire!
-			auto DelayFire = [&]
+			auto DelayFire = [this]
 			{
 				if (bWantsToFire && GetCurrentWeapon())
 				{
@@ -913,7 +827,7 @@ void AHeroCharacter::StartWeaponFire()
 				}
 			};
 
-			GetWorld()->GetTimerManager().SetTimer(RunEndTimerHandle, DelayFire, RemainingTime.GetTotalSeconds(), false);
+			Actions->Schedule(RunCooldownAction, this, RunEndAction, DelayFire);
 			return;
 		}
 
@@ -933,7 +847,8 @@ void AHeroCharacter::StopWeaponFire()
 	{
 		bWantsToFire = false;
 
-		GetWorld()->GetTimerManager().ClearTimer(RunEndTimerHandle);
+		const auto Actions = UTimedActionComponent::Get(GetWorld());
+		if (Actions) Actions->Cancel(RunEndAction);
 
 		if (GetCurrentWeapon())
 		{
@@ -967,8 +882,8 @@ AItemBase* AHeroCharacter::GetItem(EInventorySlots Slot) const
 {
 	switch (Slot)
 	{
-	case EInventorySlots::Health: return GetFirstHealthItemOrNull();
-	case EInventorySlots::Armour: return GetFirstArmourItemOrNull();
+	case EInventorySlots::Health: return InventoryComp->GetHeldItem(EInventoryCategory::Health);
+	case EInventorySlots::Armour: return InventoryComp->GetHeldItem(EInventoryCategory::Armour);
 		//case EInventorySlots::Secondary: return SecondaryWeaponSlot;
 
 	default:
@@ -981,8 +896,8 @@ IEquippable* AHeroCharacter::GetEquippable(EInventorySlots Slot) const
 	{
 	case EInventorySlots::Primary: return PrimaryWeaponSlot;
 	case EInventorySlots::Secondary: return SecondaryWeaponSlot;
-	case EInventorySlots::Health: return GetFirstHealthItemOrNull();
-	case EInventorySlots::Armour: return GetFirstArmourItemOrNull();
+	case EInventorySlots::Health: return InventoryComp->GetHeldItem(EInventoryCategory::Health);
+	case EInventorySlots::Armour: return InventoryComp->GetHeldItem(EInventoryCategory::Armour);
 
 	case EInventorySlots::Undefined:
 	default:;
@@ -991,13 +906,31 @@ IEquippable* AHeroCharacter::GetEquippable(EInventorySlots Slot) const
 	return nullptr;
 }
 
+bool AHeroCharacter::HasEquippable(EInventorySlots Slot) const
+{
+	switch (Slot)
+	{
+	case EInventorySlots::Primary: return PrimaryWeaponSlot != nullptr;
+	case EInventorySlots::Secondary: return SecondaryWeaponSlot != nullptr;
+
+	// Items are only spawned once equipped, so go by what we're carrying
+	case EInventorySlots::Health: return GetHealthItemCount() > 0;
+	case EInventorySlots::Armour: return GetArmourItemCount() > 0;
+
+	case EInventorySlots::Undefined:
+	default:;
+	}
+
+	return false;
+}
+
 int AHeroCharacter::GetHealthItemCount() const
 {
-	return HealthSlot.Num();
+	return InventoryComp->GetCount(EInventoryCategory::Health);
 }
 int AHeroCharacter::GetArmourItemCount() const
 {
-	return ArmourSlot.Num();
+	return InventoryComp->GetCount(EInventoryCategory::Armour);
 }
 
 AWeapon* AHeroCharacter::GetCurrentWeapon() const
@@ -1033,78 +966,28 @@ void AHeroCharacter::GiveItemToPlayer(TSubclassOf<AItemBase> ItemClass)
 {
 	LogMsgWithRole("AHeroCharacter::GiveItemToPlayer");
 
-	check(HasAuthority() && GetWorld() && ItemClass)
-
-
-		// Spawn the item at the hand socket
-		const auto TF = GetMesh()->GetSocketTransform(HandSocketName, RTS_World);
-		auto* Item = GetWorld()->SpawnActorDeferred<AItemBase>(
-		ItemClass,
-		TF,
-		this,
-		this,
-		ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
-
-	UGameplayStatics::FinishSpawningActor(Item, TF);
-
-	Item->SetHidden(true);
-
-	// Find correct slot
-	auto Slot = EInventorySlots::Undefined;
-
-	switch (Item->GetInventoryCategory()) {
-	case EInventoryCategory::Health: Slot = EInventorySlots::Health; break;
-	case EInventoryCategory::Armour: Slot = EInventorySlots::Armour; break;
-	case EInventoryCategory::Weapon: break;
-	case EInventoryCategory::Undefined: break;
-	case EInventoryCategory::Throwable: break;
-	default:;
-	}
+	check(HasAuthority() && ItemClass)
 
+	// Just a count. It's only spawned when it's equipped.
+	InventoryComp->AuthAdd(ItemClass);
+}
+AItemBase* AHeroCharacter::AuthMaterialiseItem(EInventoryCategory Category)
+{
+	check(HasAuthority())
 
-	// Assign Item to inventory slot - TODO Combine this with the Assign weapon to slot code
-	switch (Slot) {
+	const auto Previous = InventoryComp->GetHeldItem();
 
-	case EInventorySlots::Health:
-	{
-		// Add to inv
-		HealthSlot.Add(Item);
-		Item->EnterInventory();
-		Item->SetRecipient(this);
-		Item->SetDelegate(this);
-	}
-	break;
+	// Spawn the item at the hand socket
+	const auto TF = GetMesh()->GetSocketTransform(HandSocketName, RTS_World);
+	auto Item = InventoryComp->AuthMaterialise(Category, TF, this);
 
-	case EInventorySlots::Armour:
+	if (Item && Item != Previous)
 	{
-		// Add to inv
-		ArmourSlot.Add(Item);
-		Item->EnterInventory();
 		Item->SetRecipient(this);
 		Item->SetDelegate(this);
 	}
-	break;
-
-	case EInventorySlots::Undefined: break;
-	case EInventorySlots::Primary: break;
-	case EInventorySlots::Secondary: break;
-	default:;
-	}
 
-
-	// Put it in our hands! TODO - Or not?
-	//EquipSlot(Slot);
-
-	//LogMsgWithRole("AHeroCharacter::GiveItemToPlayer2");
-}
-
-AItemBase* AHeroCharacter::GetFirstHealthItemOrNull() const
-{
-	return HealthSlot.Num() > 0 ? HealthSlot[0] : nullptr;
-}
-AItemBase* AHeroCharacter::GetFirstArmourItemOrNull() const
-{
-	return ArmourSlot.Num() > 0 ? ArmourSlot[0] : nullptr;
+	return Item;
 }
 
 void AHeroCharacter::GiveWeaponToPlayer(TSubclassOf<class AWeapon> WeaponClass, FWeaponConfig& Config)
@@ -1195,60 +1078,6 @@ AWeapon* AHeroCharacter::AssignWeaponToInventorySlot(AWeapon* Weapon, EInventory
 	//if (Removed) Removed->Destroy();
 	return ToRemove;
 }
-bool AHeroCharacter::RemoveEquippableFromInventory(IEquippable* Equippable)
-{
-	check(Equippable);
-
-	// TODO Create a collection of items to be cleared out each tick after a second of chillin out. Just to give things a chance to settle
-
-	auto bMustChangeSlot = false;
-	bool WasRemoved = false;
-
-
-	if (Equippable->GetInventoryCategory() == EInventoryCategory::Health)
-	{
-		const auto Index = HealthSlot.IndexOfByPredicate([Equippable](AItemBase* Item)
-		{
-			return Item == Equippable;
-		});
-
-		if (Index != INDEX_NONE)
-		{
-			Equippable->ExitInventory();
-			HealthSlot.RemoveAt(Index);
-			WasRemoved = true;
-
-			bMustChangeSlot = HealthSlot.Num() == 0 && CurrentInventorySlot == EInventorySlots::Health;
-		}
-	}
-
-
-
-	if (Equippable->GetInventoryCategory() == EInventoryCategory::Armour)
-	{
-		const auto Index = ArmourSlot.IndexOfByPredicate([Equippable](AItemBase* Item)
-			{
-				return Item == Equippable;
-			});
-
-		if (Index != INDEX_NONE)
-		{
-			Equippable->ExitInventory();
-			ArmourSlot.RemoveAt(Index);
-			WasRemoved = true;
-
-			bMustChangeSlot = ArmourSlot.Num() == 0 && CurrentInventorySlot == EInventorySlots::Armour;
-		}
-	}
-
-	if (bMustChangeSlot)
-	{
-		const auto NewSlot = LastInventorySlot != CurrentInventorySlot ? LastInventorySlot : EInventorySlots::Primary;
-		EquipSlot(NewSlot);
-	}
-
-	return WasRemoved;
-}
 
 
 // Inventory - Equipping
@@ -1259,8 +1088,7 @@ void AHeroCharacter::EquipSlot(const EInventorySlots Slot)
 	if (CurrentInventorySlot == Slot) return;
 
 	// Desired slot is empty?
-	auto NewEquippable = GetEquippable(Slot);
-	if (!NewEquippable) return;
+	if (!HasEquippable(Slot)) return;
 
 
 	LastInventorySlot = CurrentInventorySlot;
@@ -1271,7 +1099,8 @@ void AHeroCharacter::EquipSlot(const EInventorySlots Slot)
 	
 
 	// Clear any existing Equip timer
-	GetWorld()->GetTimerManager().ClearTimer(EquipTimerHandle);
+	const auto Actions = UTimedActionComponent::Get(GetWorld());
+	if (Actions) Actions->Cancel(EquipAction);
 
 
 	// Unequip old 
@@ -1284,14 +1113,25 @@ void AHeroCharacter::EquipSlot(const EInventorySlots Slot)
 	}
 
 
+	// Only the item in hand exists. Clients pick it up when the server's spawned one replicates.
+	if (HasAuthority())
+	{
+		if (Slot == EInventorySlots::Health) AuthMaterialiseItem(EInventoryCategory::Health);
+		else if (Slot == EInventorySlots::Armour) AuthMaterialiseItem(EInventoryCategory::Armour);
+		else InventoryComp->AuthReleaseHeldItem();
+	}
+
+
 	// Equip new
+	auto NewEquippable = GetEquippable(Slot);
 	if (NewEquippable)
 	{
 		//LogMsgWithRole("Equip new slot");
 		NewEquippable->Equip();
 		NewEquippable->SetHidden(true);
 
-		GetWorldTimerManager().SetTimer(EquipTimerHandle, this, &AHeroCharacter::MakeEquippedItemVisible, NewEquippable->GetEquipDuration(), false);
+		if (Actions) Actions->Start(NewEquippable->GetEquipDuration(), this, EquipAction, [this] { MakeEquippedItemVisible(); });
+		else MakeEquippedItemVisible();
 	}
 
 	RefreshWeaponAttachments();
@@ -1347,12 +1187,29 @@ void AHeroCharacter::NotifyItemIsExpended(AItemBase* Item)
 	//LogMsgWithRole("AHeroCharacter::NotifyEquippableIsExpended()");
 	check(HasAuthority())
 
-	auto WasRemoved = RemoveEquippableFromInventory(Item);
-	if (WasRemoved)
+	if (Item != InventoryComp->GetHeldItem()) return;
+
+	const auto ItemClass = Item->GetClass();
+	const auto Category = Item->GetInventoryCategory();
+	InventoryComp->AuthRemoveOne(ItemClass);
+
+	// Keep the same one in hand while we've more of them
+	if (InventoryComp->GetCount(ItemClass) > 0) return;
+
+	InventoryComp->AuthReleaseHeldItem();
+
+	if (InventoryComp->GetCount(Category) > 0)
 	{
-		Item->Destroy();
-		RefreshWeaponAttachments();
+		// Something else of the same sort takes its place
+		AuthMaterialiseItem(Category);
 	}
+	else
+	{
+		const auto NewSlot = LastInventorySlot != CurrentInventorySlot ? LastInventorySlot : EInventorySlots::Primary;
+		EquipSlot(NewSlot);
+	}
+
+	RefreshWeaponAttachments();
 }
 
 
@@ -1590,6 +1447,24 @@ void AHeroCharacter::AuthApplyDamage(uint32 InstigatorHeroControllerId, float Da
 
 	if (!HasAuthority()) return;
 
+	// Hits are totalled up and resolved at the end of the frame
+	auto Aggregator = UDamageAggregatorComponent::Get(GetWorld());
+	if (Aggregator)
+	{
+		Aggregator->Add(this, InstigatorHeroControllerId, Damage, Location);
+		return;
+	}
+
+	AuthResolveDamage(InstigatorHeroControllerId, Damage, 1, Location);
+}
+
+void AHeroCharacter::AuthResolveDamage(uint32 InstigatorHeroControllerId, float Damage, int32 HitCount, const FVector& Location)
+{
+	check(HasAuthority())
+
+	// Dead already, don't kill us twice
+	if (Health <= 0) return;
+
 	auto bHitArmour = false;
 
 	if (Armour > 0)
@@ -1626,6 +1501,7 @@ void AHeroCharacter::AuthApplyDamage(uint32 InstigatorHeroControllerId, float Da
 		Hit.AttackerControllerId = InstigatorHeroControllerId;
 		Hit.HealthRemaining = (int)Health;
 		Hit.DamageTaken = (int)Damage;
+		Hit.HitCount = HitCount;
 		Hit.bHitArmour = bHitArmour;
 		Hit.HitLocation = Location;
 		//Hit.HitDirection
@@ -1736,18 +1612,15 @@ bool AHeroCharacter::CanGiveItem(const TSubclassOf<AItemBase>& Class, float& Out
 
 	// Health and Armour items have limits. Check if we're under those limits
 
-	const int HealthCount = HealthSlot.Num();
-	const int ArmourCount = ArmourSlot.Num();
+	const int HealthCount = GetHealthItemCount();
+	const int ArmourCount = GetArmourItemCount();
 
 	// If we certainly have space, lets go!
 	if (HealthCount < HealthSlotLimit && ArmourCount < ArmourSlotLimit)
 		return true;
 
 
-	// Need to create an instance to see what category it is
-	auto Temp = NewObject<AItemBase>(this, Class);
-	const auto Category = Temp->GetInventoryCategory();
-	Temp->Destroy();
+	const auto Category = UInventoryComponent::GetCategory(Class);
 
 	if (Category == EInventoryCategory::Health && HealthCount == HealthSlotLimit)
 		return false;
@@ -1811,7 +1684,7 @@ void AHeroCharacter::ServerRPC_TryInteract_Implementation()
 {
 	//LogMsgWithRole("AHeroCharacter::ServerRPC_TryInteract_Implementation()");
 
-	auto* const Pickup = ScanForInteractable<APickupBase>();
+	auto* const Pickup = InteractionComp->FindBestCandidate();
 
 	float PickupDelay;
 
@@ -1828,49 +1701,10 @@ bool AHeroCharacter::ServerRPC_TryInteract_Validate()
 	return true;
 }
 
-
-template <class T>
-T* AHeroCharacter::ScanForInteractable()
-{
-	FHitResult Hit = GetFirstPhysicsBodyInReach();
-	return Cast<T>(Hit.GetActor());
-}
-
-
-FHitResult AHeroCharacter::GetFirstPhysicsBodyInReach() const
-{
-	//LogMsgWithRole("AHeroCharacter::GetFirstPhysicsBodyInReach()");
-
-	FVector traceStart, traceEnd;
-	GetReachLine(OUT traceStart, OUT traceEnd);
-
-	bool bDrawDebug = false;
-	if (bDrawDebug) DrawDebugLine(GetWorld(), traceStart, traceEnd, FColor{255, 0, 0}, false, -1., 0, 3.f);
-
-	// Raycast along line to find intersecting physics object
-	FHitResult hitResult;
-	bool isHit = GetWorld()->LineTraceSingleByObjectType( // TODO Convert to 
-		OUT hitResult,
-		traceStart,
-		traceEnd,
-		FCollisionObjectQueryParams{ECollisionChannel::ECC_GameTraceChannel2},
-		FCollisionQueryParams{FName(""), false, GetOwner()}
-	);
-
-	if (isHit && bDrawDebug)
-	{
-		DrawDebugLine(GetWorld(), traceStart, hitResult.ImpactPoint, FColor{0, 0, 255}, false, -1., 0, 5.f);
-	}
-
-	return hitResult;
-}
-
-void AHeroCharacter::GetReachLine(OUT FVector& outStart, OUT FVector& outEnd) const
+void AHeroCharacter::SetUseMouseAim(bool bUseMouseAimIn)
 {
-	outStart = GetActorLocation();
-
-	outStart.Z -= 60; // check about ankle height
-	outEnd = outStart + GetActorRotation().Vector() * InteractableSearchDistance;
+	bUseMouseAim = bUseMouseAimIn;
+	InteractionComp->SetUseGamepadPrompts(!bUseMouseAim);
 }
 
 
@@ -5,6 +5,7 @@
 #include "CoreMinimal.h"
 #include "GameFramework/Character.h"
 #include "Interfaces/AffectableInterface.h"
+#include "TimedActionComponent.h"
 
 #include "HeroCharacter.generated.h"
 
@@ -12,6 +13,8 @@ class AHeroState;
 class AHeroController;
 class AWeapon;
 class IEquippable;
+class UInteractionComponent;
+class UInventoryComponent;
 
 DECLARE_DYNAMIC_MULTICAST_DELEGATE(FPlayerTintChanged);
 
@@ -109,10 +112,10 @@ public:
 	UPROPERTY(EditAnywhere)
 	bool bCancelReloadOnRun = false;
 
-	// Not replicated cuz diff local vs server time;
-	FDateTime LastRunEnded;
+	// Starts when running stops. Server clock, so means the same thing on both sides.
+	FTimedAction RunCooldownAction;
 
-	FTimerHandle RunEndTimerHandle;
+	FTimedActionHandle RunEndAction;
 
 	UPROPERTY(EditAnywhere)
 	float Deadzone = 0.3;
@@ -135,6 +138,12 @@ protected:
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
 		UStaticMeshComponent* AimPosComp = nullptr;
 
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+		UInteractionComponent* InteractionComp = nullptr;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+		UInventoryComponent* InventoryComp = nullptr;
+
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
 		UArrowComponent* WeaponAnchor = nullptr;
 
@@ -169,7 +178,7 @@ private:
 	FVector2D AimPos_ScreenSpace = FVector2D::ZeroVector;
 	FVector AimPos_WorldSpace = FVector::ZeroVector;
 
-	FTimerHandle EquipTimerHandle;
+	FTimedActionHandle EquipAction;
 
 	bool bIsEquipping;
 
@@ -195,15 +204,12 @@ private:
 		AWeapon* PrimaryWeaponSlot = nullptr;
 	UPROPERTY(Replicated)
 		AWeapon* SecondaryWeaponSlot = nullptr;
-	UPROPERTY(Replicated)
-		TArray<AItemBase*> HealthSlot{};
-	UPROPERTY(Replicated)
-		TArray<AItemBase*> ArmourSlot{};
 
 	
 public:
 	AHeroCharacter(const FObjectInitializer& ObjectInitializer);
 	void Restart() override;
+	void BeginPlay() override;
 	void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 	
 	void SetTint(FColor bCond)
@@ -226,6 +232,9 @@ public:
 	/* IAffectableInterface */
 	UFUNCTION()
 	void AuthApplyDamage(uint32 InstigatorHeroControllerId, float Damage, FVector Location) override;
+
+	// Everything one attacker did to us this frame, all at once
+	void AuthResolveDamage(uint32 InstigatorHeroControllerId, float Damage, int32 HitCount, const FVector& Location);
 	UFUNCTION()
 	bool CanGiveHealth() override;
 	UFUNCTION()
@@ -298,7 +307,7 @@ public:
 	void OnToggleWeapon();
 
 
-	void SetUseMouseAim(bool bUseMouseAimIn) { bUseMouseAim = bUseMouseAimIn; }
+	void SetUseMouseAim(bool bUseMouseAimIn);
 
 
 	UFUNCTION(BlueprintCallable)
@@ -316,6 +325,10 @@ public:
 
 	bool IsRunning() const { return bIsRunning; }
 	bool IsTargeting() const;
+
+	// Both are predicted through the movement component, which calls these on the server as moves arrive
+	void SetRunning(bool bNewIsRunning);
+	void SetTargeting(bool bNewTargeting);
 	float GetRunningSpeed() const { return RunningSpeed; }
 	
 	float GetRunningReloadSpeed() const { return RunningReloadSpeed; }
@@ -324,11 +337,9 @@ public:
 
 private:
 
-	bool RemoveEquippableFromInventory(IEquippable* Equippable);
 	void SpawnWeaponPickups(TArray<AWeapon*>& Weapons) const;
 	AWeapon* FindWeaponToReceiveAmmo() const;
 
-	void ScanForWeaponPickups(float DeltaSeconds);
 	virtual void Tick(float DeltaSeconds) override;
 	void TickWalking(float DT);
 	void TickRunning(float DT);
@@ -352,23 +363,18 @@ private:
 	void OnRunToggle();
 	void OnStartRunning();
 	void OnStopRunning();
-	void SetRunning(bool bNewIsRunning);
-
-
-	void SetTargeting(bool bNewTargeting);
 
 
 	bool HasAnItemEquipped() const;
 	bool HasAWeaponEquipped() const;
 
-	AItemBase* GetFirstHealthItemOrNull() const;
-	AItemBase* GetFirstArmourItemOrNull() const;
-	
 	void GiveItemToPlayer(TSubclassOf<class AItemBase> ItemClass);
+	AItemBase* AuthMaterialiseItem(EInventoryCategory Category);
 	void GiveWeaponToPlayer(TSubclassOf<class AWeapon> WeaponClass, FWeaponConfig& Config);
 	AWeapon* AuthSpawnWeapon(TSubclassOf<AWeapon> weaponClass, FWeaponConfig& Config);
 	EInventorySlots FindGoodWeaponSlot() const;
 	AWeapon* AssignWeaponToInventorySlot(AWeapon* Weapon, EInventorySlots Slot);
+	bool HasEquippable(EInventorySlots Slot) const;
 	void EquipSlot(EInventorySlots Slot);
 	void MakeEquippedItemVisible() const;
 	void RefreshWeaponAttachments() const;
@@ -382,12 +388,6 @@ private:
 	void ExperimentalMouseAimTracking(float DT);
 
 
-	UFUNCTION(Server, Reliable, WithValidation)
-		void ServerSetTargeting(bool bNewTargeting);
-
-	UFUNCTION(Server, Reliable, WithValidation)
-		void ServerSetRunning(bool bNewWantsToRun);
-
 	UFUNCTION()
 		void OnRep_TintChanged() const;
 
@@ -406,13 +406,6 @@ private:
 		void ServerToggleWeapon();
 
 
-	template<class T>
-	T* ScanForInteractable();
-
-	FHitResult GetFirstPhysicsBodyInReach() const;
-
-	void GetReachLine(FVector& outStart, FVector& outEnd) const;
-
 	void LogMsgWithRole(FString message) const;
 	FString GetRoleText() const;
 	static FString GetEnumText(ENetRole role);
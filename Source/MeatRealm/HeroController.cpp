@@ -8,10 +8,11 @@
 #include "Structs/DmgHitResult.h"
 #include "Blueprint/UserWidget.h"
 #include "DeathmatchGameMode.h"
-#include "DamageNumber.h"
+#include "DamageNumberComponent.h"
 
 AHeroController::AHeroController()
 {
+	DamageNumberComp = CreateDefaultSubobject<UDamageNumberComponent>(TEXT("DamageNumberComp"));
 }
 
 void AHeroController::CleanupPlayerState()
@@ -148,35 +149,7 @@ void AHeroController::SimulateHitGiven(const FMRHitResult& Hit)
 	//UE_LOG(LogTemp, Warning, TEXT("HitGiven() - Local. Damage(%d)"), Hit.DamageTaken);
 
 	// Display a hit marker in the world
-	const auto World = GetWorld();
-	if (World)
-	{
-		/*DrawDebugString(World, 
-			Hit.HitLocation + FVector{ 0,0,0 },
-			FString::FromInt(Hit.DamageTaken), 
-			nullptr,
-			Hit.bHitArmour ? FColor::Blue : FColor::White,
-			0.5);*/
-
-		if (DamageNumberClass == nullptr)
-		{
-			UE_LOG(LogTemp, Error, TEXT("HeroController: Must set DamageNumberClass in derived BP to display it."))
-			return;
-		}
-	
-		const FVector Location = Hit.HitLocation;
-
-		auto DamageNumber = GetWorld()->SpawnActorDeferred<ADamageNumber>(
-			DamageNumberClass,
-			FTransform{ Location }, 
-			nullptr, nullptr, 
-			ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
-
-		DamageNumber->SetDamage(Hit.DamageTaken);
-		DamageNumber->SetHitArmour(Hit.bHitArmour);
-
-		UGameplayStatics::FinishSpawningActor(DamageNumber, FTransform{ Location });
-	}
+	DamageNumberComp->AddHit(Hit);
 
 	if (OnGivenDamage.IsBound())
 		OnGivenDamage.Broadcast(Hit);
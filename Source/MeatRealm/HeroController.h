@@ -10,6 +10,7 @@
 
 class AHeroCharacter;
 class AHeroState;
+class UDamageNumberComponent;
 
 DECLARE_DYNAMIC_MULTICAST_DELEGATE(FPlayerSpawned);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FTakenDamage, FMRHitResult, Hit);
@@ -26,11 +27,11 @@ public:
 	UPROPERTY(EditDefaultsOnly, Category = "Widgets")
 		TSubclassOf<class UUserWidget> HudClass;
 
-	UPROPERTY(EditDefaultsOnly, Category = "Widgets")
-		TSubclassOf<class ADamageNumber> DamageNumberClass;
-
 	UUserWidget* HudInstance;
 
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+		UDamageNumberComponent* DamageNumberComp = nullptr;
+
 	UPROPERTY(BlueprintAssignable, Category = "Event Dispatchers")
 		FPlayerSpawned OnPlayerSpawned;
 	UPROPERTY(BlueprintAssignable, Category = "Event Dispatchers")
@@ -3,6 +3,8 @@
 
 #include "HeroState.h"
 #include "UnrealNetwork.h"
+#include "Engine/World.h"
+#include "DeathmatchGameState.h"
 
 void AHeroState::GetLifetimeReplicatedProps(TArray< FLifetimeProperty >& OutLifetimeProps) const
 {
@@ -12,3 +14,45 @@ void AHeroState::GetLifetimeReplicatedProps(TArray< FLifetimeProperty >& OutLife
 	DOREPLIFETIME(AHeroState, Deaths);
 	DOREPLIFETIME(AHeroState, HasLeftTheGame);
 }
+
+void AHeroState::AuthAddKill()
+{
+	check(HasAuthority())
+	Kills++;
+	OnRep_Score();
+}
+
+void AHeroState::AuthAddDeath()
+{
+	check(HasAuthority())
+	Deaths++;
+	OnRep_Score();
+}
+
+void AHeroState::AuthSetHasLeftTheGame()
+{
+	check(HasAuthority())
+	HasLeftTheGame = true;
+	OnRep_HasLeftTheGame();
+}
+
+void AHeroState::OnRep_PlayerName()
+{
+	Super::OnRep_PlayerName();
+
+	// Names usually arrive after the player does
+	const auto GS = GetWorld() ? GetWorld()->GetGameState<ADeathmatchGameState>() : nullptr;
+	if (GS) GS->NotifyPlayersChanged();
+}
+
+void AHeroState::OnRep_Score()
+{
+	const auto GS = GetWorld() ? GetWorld()->GetGameState<ADeathmatchGameState>() : nullptr;
+	if (GS) GS->NotifyScoreChanged(this);
+}
+
+void AHeroState::OnRep_HasLeftTheGame()
+{
+	const auto GS = GetWorld() ? GetWorld()->GetGameState<ADeathmatchGameState>() : nullptr;
+	if (GS) GS->NotifyPlayersChanged();
+}
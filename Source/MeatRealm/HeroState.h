@@ -15,13 +15,27 @@ class MEATREALM_API AHeroState : public APlayerState
 	GENERATED_BODY()
 
 public:
-	UPROPERTY(BlueprintReadOnly, Replicated)
+	UPROPERTY(BlueprintReadOnly, ReplicatedUsing=OnRep_Score)
 		int Kills = 0;
 
-	UPROPERTY(BlueprintReadOnly, Replicated)
+	UPROPERTY(BlueprintReadOnly, ReplicatedUsing=OnRep_Score)
 		int Deaths = 0;
 
 	// bIsInactive never updates as it's set to only replicate at the beginning of a game. This is stupid and makes the variable 100% useless to clients. Hence, we have our one!
-	UPROPERTY(Replicated)
+	UPROPERTY(ReplicatedUsing=OnRep_HasLeftTheGame)
 	bool HasLeftTheGame = false;
+
+	// Server. Go through these so the leaderboard hears about it.
+	void AuthAddKill();
+	void AuthAddDeath();
+	void AuthSetHasLeftTheGame();
+
+	void OnRep_PlayerName() override;
+
+private:
+	UFUNCTION()
+		void OnRep_Score();
+
+	UFUNCTION()
+		void OnRep_HasLeftTheGame();
 };
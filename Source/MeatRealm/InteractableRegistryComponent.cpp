@@ -0,0 +1,207 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "InteractableRegistryComponent.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "GameFramework/GameStateBase.h"
+#include "HAL/PlatformTime.h"
+#include "MeatRealm.h"
+#include "PickupBase.h"
+#include "Interfaces/AffectableInterface.h"
+
+DECLARE_CYCLE_STAT(TEXT("Interactable Query"), STAT_InteractableQuery, STATGROUP_MeatRealm);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Interactables Registered"), STAT_InteractablesRegistered, STATGROUP_MeatRealm);
+
+
+/// Grid
+
+int32 FInteractableGrid::Add(APickupBase* Pickup, const FVector& Location, bool bAvailable)
+{
+	FEntry Entry;
+	Entry.Pickup = Pickup;
+	Entry.Location = Location;
+	Entry.Cell = ToCell(Location);
+	Entry.bAvailable = bAvailable;
+
+	const int32 Id = Entries.Add(Entry);
+	Cells.FindOrAdd(Entry.Cell).Add(Id);
+	return Id;
+}
+
+void FInteractableGrid::Remove(int32 Id)
+{
+	const auto Cell = Entries[Id].Cell;
+
+	auto Bucket = Cells.Find(Cell);
+	if (Bucket)
+	{
+		Bucket->RemoveSingleSwap(Id, false);
+		if (Bucket->Num() == 0) Cells.Remove(Cell);
+	}
+
+	Entries.RemoveAt(Id);
+}
+
+int32 FInteractableGrid::FindNearest(const FVector& Location, const FVector& Forward, float Radius,
+	TFunctionRef<bool(const FEntry&)> Filter) const
+{
+	const auto Min = ToCell(Location - FVector{ Radius });
+	const auto Max = ToCell(Location + FVector{ Radius });
+
+	int32 Best = INDEX_NONE;
+	float BestDistSq = Radius * Radius;
+
+	for (int32 X = Min.X; X <= Max.X; ++X)
+	{
+		for (int32 Y = Min.Y; Y <= Max.Y; ++Y)
+		{
+			const auto Bucket = Cells.Find(FIntPoint{ X, Y });
+			if (!Bucket) continue;
+
+			for (const int32 Id : *Bucket)
+			{
+				const auto& Entry = Entries[Id];
+				if (!Entry.bAvailable) continue;
+
+				// Only what's in front of us, like reaching out for it
+				const auto ToEntry = Entry.Location - Location;
+				if (FVector::DotProduct(ToEntry, Forward) <= 0) continue;
+
+				const float DistSq = ToEntry.SizeSquared();
+				if (DistSq >= BestDistSq) continue;
+
+				// Last as it's the only check that might be expensive
+				if (!Filter(Entry)) continue;
+
+				Best = Id;
+				BestDistSq = DistSq;
+			}
+		}
+	}
+
+	return Best;
+}
+
+
+/// Component
+
+UInteractableRegistryComponent::UInteractableRegistryComponent()
+{
+	PrimaryComponentTick.bCanEverTick = false;
+}
+
+UInteractableRegistryComponent* UInteractableRegistryComponent::Get(const UWorld* World)
+{
+	if (!World) return nullptr;
+
+	const auto GameState = World->GetGameState();
+	return GameState ? GameState->FindComponentByClass<UInteractableRegistryComponent>() : nullptr;
+}
+
+void UInteractableRegistryComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	// On clients the game state can turn up after the level's pickups have begun play
+	for (TActorIterator<APickupBase> It(GetWorld()); It; ++It)
+	{
+		if (It->HasActorBegunPlay()) Register(*It);
+	}
+}
+
+void UInteractableRegistryComponent::Register(APickupBase* Pickup)
+{
+	check(Pickup)
+	if (!Pickup->IsExplicitInteraction() || Ids.Contains(Pickup)) return;
+
+	Ids.Add(Pickup, Grid.Add(Pickup, Pickup->GetActorLocation(), Pickup->GetIsAvailable()));
+	INC_DWORD_STAT(STAT_InteractablesRegistered);
+}
+
+void UInteractableRegistryComponent::Unregister(APickupBase* Pickup)
+{
+	int32 Id;
+	if (!Ids.RemoveAndCopyValue(Pickup, Id)) return;
+
+	Grid.Remove(Id);
+	DEC_DWORD_STAT(STAT_InteractablesRegistered);
+}
+
+void UInteractableRegistryComponent::SetAvailable(APickupBase* Pickup, bool bAvailable)
+{
+	const auto Id = Ids.Find(Pickup);
+	if (Id) Grid.SetAvailable(*Id, bAvailable);
+}
+
+APickupBase* UInteractableRegistryComponent::FindBest(const FVector& Location, const FVector& Forward, float Radius,
+	IAffectableInterface* Affectable) const
+{
+	SCOPE_CYCLE_COUNTER(STAT_InteractableQuery);
+
+	const int32 Id = Grid.FindNearest(Location, Forward, Radius, [Affectable](const FInteractableGrid::FEntry& Entry)
+	{
+		auto Pickup = Entry.Pickup.Get();
+		float Delay;
+		return Pickup && Pickup->CanInteract(Affectable, OUT Delay);
+	});
+
+	return Id == INDEX_NONE ? nullptr : Grid.GetPickup(Id);
+}
+
+void UInteractableRegistryComponent::Benchmark(int32 NumEntries, int32 NumQueries)
+{
+	// A generous arena, roughly the size of our biggest map
+	const float ArenaSize = 10000;
+	const float Radius = 150;
+
+	FRandomStream Stream{ 1234 };
+	auto RandomPoint = [&] { return FVector{ Stream.FRandRange(0, ArenaSize), Stream.FRandRange(0, ArenaSize), 0 }; };
+
+	FInteractableGrid BenchGrid;
+	TArray<FVector> Points;
+	for (int32 i = 0; i < NumEntries; ++i)
+	{
+		Points.Add(RandomPoint());
+		BenchGrid.Add(nullptr, Points.Last(), true);
+	}
+
+	TArray<FVector> Queries;
+	for (int32 i = 0; i < NumQueries; ++i)
+	{
+		Queries.Add(RandomPoint());
+	}
+
+	const FVector Forward = FVector::ForwardVector;
+	auto AcceptAll = [](const FInteractableGrid::FEntry&) { return true; };
+
+	int32 GridFound = 0;
+	double Start = FPlatformTime::Seconds();
+	for (const auto& Query : Queries)
+	{
+		if (BenchGrid.FindNearest(Query, Forward, Radius, AcceptAll) != INDEX_NONE) ++GridFound;
+	}
+	const double GridTime = FPlatformTime::Seconds() - Start;
+
+	int32 LinearFound = 0;
+	Start = FPlatformTime::Seconds();
+	for (const auto& Query : Queries)
+	{
+		float BestDistSq = Radius * Radius;
+		int32 Best = INDEX_NONE;
+		for (int32 i = 0; i < Points.Num(); ++i)
+		{
+			const auto ToPoint = Points[i] - Query;
+			if (FVector::DotProduct(ToPoint, Forward) <= 0) continue;
+			const float DistSq = ToPoint.SizeSquared();
+			if (DistSq < BestDistSq) { Best = i; BestDistSq = DistSq; }
+		}
+		if (Best != INDEX_NONE) ++LinearFound;
+	}
+	const double LinearTime = FPlatformTime::Seconds() - Start;
+
+	UE_LOG(LogTemp, Warning, TEXT("Interactable benchmark: %d entries, %d queries. Grid %.3fms (%.3fus/query, %d found). Linear %.3fms (%.3fus/query, %d found)"),
+		NumEntries, NumQueries,
+		GridTime * 1000, GridTime * 1000000 / FMath::Max(NumQueries, 1), GridFound,
+		LinearTime * 1000, LinearTime * 1000000 / FMath::Max(NumQueries, 1), LinearFound);
+}
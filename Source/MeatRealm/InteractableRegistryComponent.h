@@ -0,0 +1,80 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "Containers/SparseArray.h"
+
+#include "InteractableRegistryComponent.generated.h"
+
+class APickupBase;
+
+/**
+ * Uniform 2D grid of points. Cells are at least as big as the usual search radius, so a query only
+ * ever looks at a handful of cells no matter how many entries there are.
+ */
+struct MEATREALM_API FInteractableGrid
+{
+	struct FEntry
+	{
+		TWeakObjectPtr<APickupBase> Pickup;
+		FVector Location;
+		FIntPoint Cell;
+		bool bAvailable = true;
+	};
+
+	explicit FInteractableGrid(float CellSizeIn = 200.f) : CellSize(CellSizeIn) {}
+
+	int32 Add(APickupBase* Pickup, const FVector& Location, bool bAvailable);
+	void Remove(int32 Id);
+	void SetAvailable(int32 Id, bool bAvailable) { Entries[Id].bAvailable = bAvailable; }
+	int32 Num() const { return Entries.Num(); }
+	APickupBase* GetPickup(int32 Id) const { return Entries[Id].Pickup.Get(); }
+
+	// Nearest available entry within Radius that's in front of Forward and passes Filter. INDEX_NONE when nothing is.
+	int32 FindNearest(const FVector& Location, const FVector& Forward, float Radius,
+		TFunctionRef<bool(const FEntry&)> Filter) const;
+
+private:
+	FIntPoint ToCell(const FVector& Location) const
+	{
+		return FIntPoint{ FMath::FloorToInt(Location.X / CellSize), FMath::FloorToInt(Location.Y / CellSize) };
+	}
+
+	float CellSize;
+	TSparseArray<FEntry> Entries;
+	TMap<FIntPoint, TArray<int32, TInlineAllocator<4>>> Cells;
+};
+
+/**
+ * Every pickup that has to be interacted with, bucketed by where it is. Lives on the game state and is kept
+ * on server and clients alike, so the prompt a player sees and what the server lets them grab agree.
+ */
+UCLASS(ClassGroup = (Custom))
+class MEATREALM_API UInteractableRegistryComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+private:
+	FInteractableGrid Grid;
+	TMap<const APickupBase*, int32> Ids;
+
+
+public:
+	UInteractableRegistryComponent();
+	static UInteractableRegistryComponent* Get(const UWorld* World);
+
+	void Register(APickupBase* Pickup);
+	void Unregister(APickupBase* Pickup);
+	void SetAvailable(APickupBase* Pickup, bool bAvailable);
+
+	// The pickup closest to Location within Radius, in front of Forward, that Affectable can interact with
+	APickupBase* FindBest(const FVector& Location, const FVector& Forward, float Radius, class IAffectableInterface* Affectable) const;
+
+	// Times queries against a grid of NumEntries random points and compares to checking every one. Logs the result.
+	static void Benchmark(int32 NumEntries, int32 NumQueries);
+
+protected:
+	void BeginPlay() override;
+};
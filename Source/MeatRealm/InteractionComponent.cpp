@@ -0,0 +1,171 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "InteractionComponent.h"
+#include "GameFramework/InputSettings.h"
+#include "GameFramework/Pawn.h"
+#include "Blueprint/UserWidget.h"
+#include "WidgetComponent.h"
+#include "DrawDebugHelpers.h"
+#include "Engine/World.h"
+#include "PickupBase.h"
+#include "InteractableRegistryComponent.h"
+#include "Interfaces/AffectableInterface.h"
+
+UInteractionComponent::UInteractionComponent()
+{
+	PrimaryComponentTick.bCanEverTick = true;
+}
+
+void UInteractionComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	// Only players need prompts
+	if (IsNetMode(NM_DedicatedServer)) SetComponentTickEnabled(false);
+}
+
+void UInteractionComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	SetFocus(nullptr);
+	if (PromptWidget)
+	{
+		PromptWidget->DestroyComponent();
+		PromptWidget = nullptr;
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void UInteractionComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	// Possession can come and go, so check rather than turn the tick off
+	if (!IsLocallyControlled())
+	{
+		SetFocus(nullptr);
+		return;
+	}
+
+	// Focus changes as we move, turn or as a pickup is taken, so this stays per frame. It's a few grid cells.
+	SetFocus(FindBestCandidate());
+
+	if (FocusedPickup.IsValid() && !PromptWidget)
+	{
+		const auto YOffset = -5.f * PromptString.Len();
+		DrawDebugString(GetWorld(), PromptOffset + FVector{ 0, YOffset, 0 }, PromptString, FocusedPickup.Get(), FColor::White, DeltaTime * 0.5);
+	}
+}
+
+APickupBase* UInteractionComponent::FindBestCandidate() const
+{
+	const auto Owner = GetOwner();
+	auto Affectable = Cast<IAffectableInterface>(Owner);
+	auto Registry = UInteractableRegistryComponent::Get(GetWorld());
+	if (!Affectable || !Registry) return nullptr;
+
+	return Registry->FindBest(Owner->GetActorLocation(), Owner->GetActorForwardVector(), SearchDistance, Affectable);
+}
+
+void UInteractionComponent::SetUseGamepadPrompts(bool bUseGamepad)
+{
+	if (bUseGamepadPrompts == bUseGamepad) return;
+
+	bUseGamepadPrompts = bUseGamepad;
+	RefreshKeyNames();
+}
+
+void UInteractionComponent::SetFocus(APickupBase* Pickup)
+{
+	if (FocusedPickup == Pickup) return;
+
+	FocusedPickup = Pickup;
+	RefreshPrompt();
+}
+
+void UInteractionComponent::RefreshPrompt()
+{
+	auto Pickup = FocusedPickup.Get();
+
+	if (Pickup)
+	{
+		PromptString = FString::Printf(TEXT("Grab %s (%s)"), *Pickup->GetPickupName(), *GetInteractKeyName());
+		PromptText = FText::FromString(PromptString);
+	}
+	else
+	{
+		PromptString.Reset();
+		PromptText = FText::GetEmpty();
+	}
+
+	// One prompt widget, moved to whatever we're looking at
+	if (PromptWidgetClass)
+	{
+		if (!PromptWidget && Pickup)
+		{
+			PromptWidget = NewObject<UWidgetComponent>(GetOwner(), TEXT("InteractionPrompt"));
+			PromptWidget->SetWidgetSpace(EWidgetSpace::Screen);
+			PromptWidget->SetWidgetClass(PromptWidgetClass);
+			PromptWidget->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+			PromptWidget->RegisterComponent();
+		}
+
+		if (PromptWidget)
+		{
+			if (Pickup)
+			{
+				PromptWidget->AttachToComponent(Pickup->GetRootComponent(), FAttachmentTransformRules::KeepRelativeTransform);
+				PromptWidget->SetRelativeLocation(PromptOffset);
+			}
+			PromptWidget->SetVisibility(Pickup != nullptr);
+		}
+	}
+
+	OnPromptChanged.Broadcast();
+}
+
+const FString& UInteractionComponent::GetInteractKeyName()
+{
+	if (bKeyNameIsValid) return InteractKeyName;
+
+	InteractKeyName = "Undefined";
+	bKeyNameIsValid = true;
+
+	TArray<FInputActionKeyMapping> Mappings;
+	UInputSettings::GetInputSettings()->GetActionMappingByName("Interact", OUT Mappings);
+
+	for (const auto& Mapping : Mappings)
+	{
+		if (Mapping.Key.IsGamepadKey() != bUseGamepadPrompts) continue;
+
+		InteractKeyName = bUseGamepadPrompts ? GetShortKeyName(Mapping.Key) : Mapping.Key.GetDisplayName().ToString();
+		break;
+	}
+
+	return InteractKeyName;
+}
+
+FString UInteractionComponent::GetShortKeyName(const FKey& Key)
+{
+	// Make the gamepad text not bloody horrible
+	if (Key == EKeys::Gamepad_FaceButton_Bottom) return "A";
+	if (Key == EKeys::Gamepad_FaceButton_Right) return "B";
+	if (Key == EKeys::Gamepad_FaceButton_Left) return "X";
+	if (Key == EKeys::Gamepad_FaceButton_Top) return "Y";
+	if (Key == EKeys::Gamepad_DPad_Up) return "Up";
+	if (Key == EKeys::Gamepad_DPad_Down) return "Down";
+	if (Key == EKeys::Gamepad_DPad_Right) return "Right";
+	if (Key == EKeys::Gamepad_DPad_Left) return "Left";
+	if (Key == EKeys::Gamepad_LeftShoulder) return "LB";
+	if (Key == EKeys::Gamepad_RightShoulder) return "RB";
+	if (Key == EKeys::Gamepad_LeftTrigger) return "LT";
+	if (Key == EKeys::Gamepad_RightTrigger) return "RT";
+	return Key.ToString();
+}
+
+bool UInteractionComponent::IsLocallyControlled() const
+{
+	auto Pawn = Cast<APawn>(GetOwner());
+	return Pawn && Pawn->IsLocallyControlled();
+}
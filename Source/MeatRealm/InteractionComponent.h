@@ -0,0 +1,80 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+
+#include "InteractionComponent.generated.h"
+
+class APickupBase;
+class UUserWidget;
+class UWidgetComponent;
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE(FInteractionPromptChanged);
+
+/**
+ * Picks the pickup a hero would interact with from the world's interactable registry.
+ * On the local player it also owns the "Grab X (E)" prompt, which is only rebuilt when the focus,
+ * the input device or the bindings change.
+ */
+UCLASS(ClassGroup = (Custom))
+class MEATREALM_API UInteractionComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY(BlueprintAssignable, Category = "Event Dispatchers")
+		FInteractionPromptChanged OnPromptChanged;
+
+	UPROPERTY(EditAnywhere)
+		float SearchDistance = 150.f; //cm
+
+	// Optional. Without one the prompt is drawn as debug text.
+	UPROPERTY(EditDefaultsOnly)
+		TSubclassOf<UUserWidget> PromptWidgetClass;
+
+	UPROPERTY(EditDefaultsOnly)
+		FVector PromptOffset = FVector{ 50, 0, 100 };
+
+private:
+	TWeakObjectPtr<APickupBase> FocusedPickup;
+
+	UPROPERTY()
+		UWidgetComponent* PromptWidget = nullptr;
+
+	UPROPERTY()
+		FText PromptText;
+
+	FString PromptString;
+	FString InteractKeyName;
+	bool bKeyNameIsValid = false;
+	bool bUseGamepadPrompts = false;
+
+
+public:
+	UInteractionComponent();
+
+	// The pickup the hero would grab right now, if any. Safe to call on the server.
+	APickupBase* FindBestCandidate() const;
+
+	UFUNCTION(BlueprintCallable)
+		FText GetPromptText() const { return PromptText; }
+
+	void SetUseGamepadPrompts(bool bUseGamepad);
+
+	// Call after the interact binding is changed
+	void RefreshKeyNames() { bKeyNameIsValid = false; RefreshPrompt(); }
+
+protected:
+	void BeginPlay() override;
+	void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+	void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+private:
+	bool IsLocallyControlled() const;
+	void SetFocus(APickupBase* Pickup);
+	void RefreshPrompt();
+	const FString& GetInteractKeyName();
+	static FString GetShortKeyName(const FKey& Key);
+};
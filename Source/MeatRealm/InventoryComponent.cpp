@@ -0,0 +1,134 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "InventoryComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/Pawn.h"
+#include "Kismet/GameplayStatics.h"
+#include "UnrealNetwork.h"
+#include "ItemBase.h"
+
+void UInventoryComponent::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	DOREPLIFETIME_CONDITION(UInventoryComponent, Items, COND_OwnerOnly);
+	DOREPLIFETIME_CONDITION(UInventoryComponent, HeldItem, COND_OwnerOnly);
+}
+
+UInventoryComponent::UInventoryComponent()
+{
+	PrimaryComponentTick.bCanEverTick = false;
+	SetIsReplicated(true);
+}
+
+EInventoryCategory UInventoryComponent::GetCategory(TSubclassOf<AItemBase> ItemClass)
+{
+	return ItemClass ? ItemClass->GetDefaultObject<AItemBase>()->GetInventoryCategory() : EInventoryCategory::Undefined;
+}
+
+int32 UInventoryComponent::GetCount(EInventoryCategory Category) const
+{
+	int32 Count = 0;
+	for (const auto& Stack : Items.Stacks)
+	{
+		if (Stack.Category == Category) Count += Stack.Count;
+	}
+	return Count;
+}
+
+int32 UInventoryComponent::GetCount(TSubclassOf<AItemBase> ItemClass) const
+{
+	for (const auto& Stack : Items.Stacks)
+	{
+		if (Stack.ItemClass == ItemClass) return Stack.Count;
+	}
+	return 0;
+}
+
+AItemBase* UInventoryComponent::GetHeldItem(EInventoryCategory Category) const
+{
+	return HeldItem && HeldItem->GetInventoryCategory() == Category ? HeldItem : nullptr;
+}
+
+FInventoryStack* UInventoryComponent::FindStack(TSubclassOf<AItemBase> ItemClass)
+{
+	return Items.Stacks.FindByPredicate([ItemClass](const FInventoryStack& Stack) { return Stack.ItemClass == ItemClass; });
+}
+
+void UInventoryComponent::AuthAdd(TSubclassOf<AItemBase> ItemClass)
+{
+	check(GetOwner()->HasAuthority() && ItemClass)
+
+	auto Stack = FindStack(ItemClass);
+	if (!Stack)
+	{
+		Stack = &Items.Stacks.AddDefaulted_GetRef();
+		Stack->ItemClass = ItemClass;
+		Stack->Category = GetCategory(ItemClass);
+	}
+
+	++Stack->Count;
+	Items.MarkItemDirty(*Stack);
+}
+
+void UInventoryComponent::AuthRemoveOne(TSubclassOf<AItemBase> ItemClass)
+{
+	check(GetOwner()->HasAuthority())
+
+	const int32 Index = Items.Stacks.IndexOfByPredicate([ItemClass](const FInventoryStack& Stack) { return Stack.ItemClass == ItemClass; });
+	if (Index == INDEX_NONE) return;
+
+	auto& Stack = Items.Stacks[Index];
+	if (--Stack.Count > 0)
+	{
+		Items.MarkItemDirty(Stack);
+		return;
+	}
+
+	Items.Stacks.RemoveAt(Index);
+	Items.MarkArrayDirty();
+}
+
+void UInventoryComponent::AuthClear()
+{
+	check(GetOwner()->HasAuthority())
+
+	AuthReleaseHeldItem();
+	Items.Stacks.Empty();
+	Items.MarkArrayDirty();
+}
+
+AItemBase* UInventoryComponent::AuthMaterialise(EInventoryCategory Category, const FTransform& Where, APawn* Instigator)
+{
+	check(GetOwner()->HasAuthority())
+
+	if (HeldItem && HeldItem->GetInventoryCategory() == Category) return HeldItem;
+	AuthReleaseHeldItem();
+
+	const auto Stack = Items.Stacks.FindByPredicate([Category](const FInventoryStack& S) { return S.Category == Category; });
+	if (!Stack) return nullptr;
+
+	HeldItem = GetWorld()->SpawnActorDeferred<AItemBase>(
+		Stack->ItemClass,
+		Where,
+		GetOwner(),
+		Instigator,
+		ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
+
+	UGameplayStatics::FinishSpawningActor(HeldItem, Where);
+
+	HeldItem->SetHidden(true);
+	HeldItem->EnterInventory();
+	return HeldItem;
+}
+
+void UInventoryComponent::AuthReleaseHeldItem()
+{
+	check(GetOwner()->HasAuthority())
+	if (!HeldItem) return;
+
+	HeldItem->ExitInventory();
+	HeldItem->Destroy();
+	HeldItem = nullptr;
+}
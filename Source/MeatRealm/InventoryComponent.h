@@ -0,0 +1,91 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "Engine/NetSerialization.h"
+#include "Interfaces/Equippable.h"
+
+#include "InventoryComponent.generated.h"
+
+class AItemBase;
+class APawn;
+
+// How many of one kind of item we're carrying
+USTRUCT()
+struct FInventoryStack : public FFastArraySerializerItem
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+		TSubclassOf<AItemBase> ItemClass;
+
+	UPROPERTY()
+		EInventoryCategory Category = EInventoryCategory::Undefined;
+
+	UPROPERTY()
+		uint8 Count = 0;
+};
+
+USTRUCT()
+struct FInventoryStacks : public FFastArraySerializer
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+		TArray<FInventoryStack> Stacks;
+
+	bool NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms)
+	{
+		return FFastArraySerializer::FastArrayDeltaSerialize<FInventoryStack, FInventoryStacks>(Stacks, DeltaParms, *this);
+	}
+};
+
+template<>
+struct TStructOpsTypeTraits<FInventoryStacks> : public TStructOpsTypeTraitsBase2<FInventoryStacks>
+{
+	enum { WithNetDeltaSerializer = true };
+};
+
+/**
+ * Consumable items (health, armour) kept as counts rather than actors. Only the one in hand exists as an
+ * AItemBase, and only while its category is equipped. Counts replicate to the owner as deltas.
+ */
+UCLASS(ClassGroup = (Custom))
+class MEATREALM_API UInventoryComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+private:
+	UPROPERTY(Replicated)
+		FInventoryStacks Items;
+
+	// The materialised item, if any
+	UPROPERTY(Replicated)
+		AItemBase* HeldItem = nullptr;
+
+
+public:
+	UInventoryComponent();
+
+	static EInventoryCategory GetCategory(TSubclassOf<AItemBase> ItemClass);
+
+	int32 GetCount(EInventoryCategory Category) const;
+	int32 GetCount(TSubclassOf<AItemBase> ItemClass) const;
+
+	// The held item, if it's of Category
+	AItemBase* GetHeldItem(EInventoryCategory Category) const;
+	AItemBase* GetHeldItem() const { return HeldItem; }
+
+	void AuthAdd(TSubclassOf<AItemBase> ItemClass);
+	void AuthRemoveOne(TSubclassOf<AItemBase> ItemClass);
+	void AuthClear();
+
+	// Spawns the first item of Category in hand unless one's already there. Replaces any other held item.
+	AItemBase* AuthMaterialise(EInventoryCategory Category, const FTransform& Where, APawn* Instigator);
+	void AuthReleaseHeldItem();
+
+private:
+	FInventoryStack* FindStack(TSubclassOf<AItemBase> ItemClass);
+};
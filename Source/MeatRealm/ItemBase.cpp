@@ -7,14 +7,21 @@
 #include "Components/SkeletalMeshComponent.h"
 #include "HeroCharacter.h"
 #include "UnrealNetwork.h"
+#include "GameplayClock.h"
+
+void AItemBase::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+	DOREPLIFETIME(AItemBase, Usage);
+}
 
 AItemBase::AItemBase()
 {
 	bAlwaysRelevant = true;
 	SetReplicates(true);
 
-	PrimaryActorTick.bCanEverTick = true;
-	RegisterAllActorTickFunctions(true, false); // necessary for SetActorTickEnabled() to work
+	// Usage runs on the world's timed actions, nothing to tick
+	PrimaryActorTick.bCanEverTick = false;
 
 	RootComp = CreateDefaultSubobject<USceneComponent>(TEXT("Root"));
 	RootComponent = RootComp;
@@ -48,26 +55,17 @@ void AItemBase::BeginPlay()
 {
 	UE_LOG(LogTemp, Warning, TEXT("AItemBase::BeginPlay"));
 	Super::BeginPlay();
-	//SetActorTickInterval(.1); // tick every 10th of a sec
-	SetActorTickEnabled(false);
 }
 
 float AItemBase::GetUsageTimeRemaining() const
 {
-	return (1 - UsageProgress) * UsageDuration;
+	return (1 - GetUsageProgress()) * UsageDuration;
 }
 
-void AItemBase::Tick(float DT)
+float AItemBase::GetUsageProgress() const
 {
-	if (HasAuthority()) return;
-
-	// Do client side progress update
-	if (bIsInUse)
-	{
-		const auto ElapsedReloadTime = (FDateTime::Now() - UsageStartTime).GetTotalSeconds();
-		UsageProgress = ElapsedReloadTime / UsageDuration;
-		//UE_LOG(LogTemp, Warning, TEXT("AItemBase::Tick - Progress:%f"), UsageProgress);
-	}
+	if (!bIsInUse) return UsageProgress;
+	return Usage.GetProgress(FGameplayClock::Now(GetWorld()));
 }
 
 void AItemBase::UsePressed()
@@ -89,14 +87,15 @@ void AItemBase::UsePressed()
 		return;
 	}
 
+	auto Actions = UTimedActionComponent::Get(GetWorld());
+	if (!ensure(Actions)) return;
+
 	// Start the usage!
-	SetActorTickEnabled(true);
 	bIsInUse = true;
-	UsageStartTime = FDateTime::Now();
 	UsageProgress = 0;
 	OnUsageStarted.Broadcast();
 
-	GetWorldTimerManager().SetTimer(UsageTimerHandle, this, &AItemBase::UseComplete, UsageDuration, false);
+	Usage = Actions->Start(UsageDuration, this, UsageHandle, [this] { UseComplete(); });
 }
 
 void AItemBase::UseComplete()
@@ -105,7 +104,7 @@ void AItemBase::UseComplete()
 
 	bIsInUse = false;
 	UsageProgress = 100;
-	SetActorTickEnabled(false);
+	Usage.Clear();
 
 	if (OnUsageSuccess.IsBound()) OnUsageSuccess.Broadcast(); // There was a crash here... Not sure the issue
 
@@ -149,14 +148,36 @@ void AItemBase::StopAnyUsage()
 {
 	if (!bIsInUse) return;
 
-	GetWorldTimerManager().ClearTimer(UsageTimerHandle);
-	SetActorTickEnabled(false);
+	auto Actions = UTimedActionComponent::Get(GetWorld());
+	if (Actions) Actions->Cancel(UsageHandle);
+	Usage.Clear();
 	bIsInUse = false;
 	UsageProgress = 0;
 
 	OnUsageCancelled.Broadcast();
 }
 
+void AItemBase::OnRep_Usage()
+{
+	// Usage we didn't start ourselves, like the server auto using us on equip before we'd even replicated
+	if (Usage.IsRunning() && !bIsInUse)
+	{
+		bIsInUse = true;
+		UsageProgress = 0;
+		OnUsageStarted.Broadcast();
+		return;
+	}
+
+	// Same again for it stopping. Usage we started locally finishes on its own.
+	auto Actions = UTimedActionComponent::Get(GetWorld());
+	const bool bIsPendingHere = Actions && Actions->IsPending(UsageHandle);
+	if (!Usage.IsRunning() && bIsInUse && !bIsPendingHere)
+	{
+		bIsInUse = false;
+		UsageProgress = 0;
+	}
+}
+
 void AItemBase::SetRecipient(IAffectableInterface* const TheRecipient)
 {
 	check(HasAuthority())
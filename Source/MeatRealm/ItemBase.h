@@ -4,8 +4,8 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
-#include "TimerManager.h"
 #include "Interfaces/Equippable.h"
+#include "TimedActionComponent.h"
 
 #include "ItemBase.generated.h"
 
@@ -25,6 +25,7 @@ class MEATREALM_API AItemBase : public AActor, public IEquippable
 
 public:
 protected:
+	// Only updated when usage starts and stops. Use GetUsageProgress() for a live value.
 	UPROPERTY(BlueprintReadOnly)
 		float UsageProgress = 0;
 
@@ -46,8 +47,11 @@ protected:
 
 
 private:
-	FDateTime UsageStartTime;
-	FTimerHandle UsageTimerHandle;
+	// Clients work out progress from this
+	UPROPERTY(ReplicatedUsing = OnRep_Usage)
+		FTimedAction Usage;
+
+	FTimedActionHandle UsageHandle;
 	IAffectableInterface* Recipient = nullptr;
 	AHeroCharacter* Delegate = nullptr; // TODO This is a horrible coupling. Make it a UInventoryComponent. Using an interface is a fools errand in UE4
 
@@ -116,14 +120,18 @@ protected:
 	UFUNCTION(BlueprintCallable)
 		float GetUsageTimeRemaining() const;
 
+	UFUNCTION(BlueprintCallable)
+		float GetUsageProgress() const;
+
 
 private:
 	virtual void BeginPlay() override;
 
-	void Tick(float DeltaSeconds) override;
-
 	void StopAnyUsage();
 
+	UFUNCTION()
+		void OnRep_Usage();
+
 	UFUNCTION(Server, Reliable, WithValidation)
 		void ServerUsePressed();
 
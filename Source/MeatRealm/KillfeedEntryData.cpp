@@ -2,11 +2,14 @@
 
 
 #include "KillfeedEntryData.h"
-#include "UnrealNetwork.h"
+#include "DeathmatchGameState.h"
 
-void UKillfeedEntryData::GetLifetimeReplicatedProps(TArray< FLifetimeProperty >& OutLifetimeProps) const
+void FKillfeedEntry::PostReplicatedAdd(const FKillfeed& InArraySerializer)
 {
-	DOREPLIFETIME(UKillfeedEntryData, Winner);
-	DOREPLIFETIME(UKillfeedEntryData, Verb);
-	DOREPLIFETIME(UKillfeedEntryData, Loser);
+	if (InArraySerializer.Owner) InArraySerializer.Owner->OnRep_KillfeedDataChanged();
+}
+
+void FKillfeedEntry::PreReplicatedRemove(const FKillfeed& InArraySerializer)
+{
+	if (InArraySerializer.Owner) InArraySerializer.Owner->OnRep_KillfeedDataChanged();
 }
@@ -3,30 +3,57 @@
 #pragma once
 
 #include "CoreMinimal.h"
-#include "UObject/NoExportTypes.h"
-#include "GameFramework/Info.h"
+#include "Engine/NetSerialization.h"
 
 #include "KillfeedEntryData.generated.h"
 
+class ADeathmatchGameState;
+struct FKillfeed;
 
-UCLASS(BlueprintType)
-class MEATREALM_API UKillfeedEntryData : public UActorComponent
+USTRUCT(BlueprintType)
+struct MEATREALM_API FKillfeedEntry : public FFastArraySerializerItem
 {
 	GENERATED_BODY()
 
-public:
-	
-	virtual bool IsSupportedForNetworking() const override
-	{
-		return true;
-	}
-
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Replicated)
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
 		FString Winner = "Winrar";
 
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Replicated)
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
 		FString Verb = "Blapped";
 
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Replicated)
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
 		FString Loser = "Ded";
+
+	// Server world time of the kill, see FGameplayClock::Now(). Each machine expires entries from this itself.
+	UPROPERTY()
+		float Time = 0;
+
+	// Adds are applied before removals, so either may see evicted entries still in the list. GetKillfeed() trims them.
+	void PostReplicatedAdd(const FKillfeed& InArraySerializer);
+	void PreReplicatedRemove(const FKillfeed& InArraySerializer);
+};
+
+// The last few kills. Oldest first on the server only, clients get them in whatever order the fast array leaves them.
+// Only new and dropped entries go over the wire.
+USTRUCT()
+struct MEATREALM_API FKillfeed : public FFastArraySerializer
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+		TArray<FKillfeedEntry> Entries;
+
+	// Told when entries arrive or leave on a client
+	ADeathmatchGameState* Owner = nullptr;
+
+	bool NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms)
+	{
+		return FFastArraySerializer::FastArrayDeltaSerialize<FKillfeedEntry, FKillfeed>(Entries, DeltaParms, *this);
+	}
+};
+
+template<>
+struct TStructOpsTypeTraits<FKillfeed> : public TStructOpsTypeTraitsBase2<FKillfeed>
+{
+	enum { WithNetDeltaSerializer = true };
 };
@@ -0,0 +1,193 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "LagCompensationComponent.h"
+#include "Components/CapsuleComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/GameStateBase.h"
+#include "GameFramework/PlayerState.h"
+#include "MeatRealm.h"
+#include "GameplayClock.h"
+
+DECLARE_CYCLE_STAT(TEXT("Lag Comp Record"), STAT_LagCompRecord, STATGROUP_MeatRealm);
+DECLARE_CYCLE_STAT(TEXT("Lag Comp Rewind"), STAT_LagCompRewind, STATGROUP_MeatRealm);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Lag Comp Rewinds"), STAT_LagCompRewinds, STATGROUP_MeatRealm);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Lag Comp Tracked"), STAT_LagCompTracked, STATGROUP_MeatRealm);
+
+ULagCompensationComponent::ULagCompensationComponent()
+{
+	PrimaryComponentTick.bCanEverTick = true;
+
+	// Record after movement has settled for the frame
+	PrimaryComponentTick.TickGroup = TG_PostPhysics;
+}
+
+ULagCompensationComponent* ULagCompensationComponent::Get(const UWorld* World)
+{
+	if (!World) return nullptr;
+
+	const auto GameState = World->GetGameState();
+	return GameState ? GameState->FindComponentByClass<ULagCompensationComponent>() : nullptr;
+}
+
+void ULagCompensationComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	// Only the server resolves hits
+	if (!GetOwner()->HasAuthority())
+	{
+		SetComponentTickEnabled(false);
+		return;
+	}
+
+	Histories.SetNum(MaxTrackedActors);
+}
+
+void ULagCompensationComponent::Register(AActor* Actor, UCapsuleComponent* Capsule)
+{
+	if (!Actor || !Capsule) return;
+
+	FHistory* Free = nullptr;
+	for (auto& History : Histories)
+	{
+		if (History.Actor.Get() == Actor) return;
+		if (!Free && !History.Actor.IsValid()) Free = &History;
+	}
+
+	if (!Free)
+	{
+		UE_LOG(LogTemp, Error, TEXT("ULagCompensationComponent::Register() - Out of slots, %s won't be lag compensated. Raise MaxTrackedActors"), *Actor->GetName());
+		return;
+	}
+
+	Free->Actor = Actor;
+	Free->Capsule = Capsule;
+	Free->Head = 0;
+	Free->Count = 0;
+}
+
+void ULagCompensationComponent::Unregister(AActor* Actor)
+{
+	for (auto& History : Histories)
+	{
+		if (History.Actor.Get() == Actor)
+		{
+			History.Actor = nullptr;
+			History.Capsule = nullptr;
+			History.Count = 0;
+			return;
+		}
+	}
+}
+
+float ULagCompensationComponent::GetRewindTime(const APlayerState* Shooter) const
+{
+	if (!Shooter) return 0;
+
+	// ExactPing is a round trip in ms. The client saw a world that old by the time its shot reaches us.
+	return FMath::Clamp(Shooter->ExactPing * 0.001f, 0.f, MaxRewindTime);
+}
+
+void ULagCompensationComponent::TickComponent(float DeltaTime, ELevelTick TickType,
+	FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	SCOPE_CYCLE_COUNTER(STAT_LagCompRecord);
+
+	const float Now = FGameplayClock::LocalNow(GetWorld());
+	int32 NumTracked = 0;
+
+	for (auto& History : Histories)
+	{
+		const auto Capsule = History.Capsule.Get();
+		if (!History.Actor.IsValid() || !Capsule)
+		{
+			History.Actor = nullptr;
+			History.Count = 0;
+			continue;
+		}
+
+		History.Head = (History.Head + 1) % HistorySize;
+		History.Count = FMath::Min(History.Count + 1, HistorySize);
+
+		auto& Sample = History.Samples[History.Head];
+		Sample.Time = Now;
+		Sample.Center = Capsule->GetComponentLocation();
+		Sample.Rotation = Capsule->GetComponentQuat();
+
+		++NumTracked;
+	}
+
+	SET_DWORD_STAT(STAT_LagCompTracked, NumTracked);
+}
+
+void ULagCompensationComponent::GetCapsulesAt(float Time, TArray<FRewoundCapsule>& Out) const
+{
+	SCOPE_CYCLE_COUNTER(STAT_LagCompRewind);
+	INC_DWORD_STAT(STAT_LagCompRewinds);
+
+	Out.Reset();
+
+	for (const auto& History : Histories)
+	{
+		const auto Capsule = History.Capsule.Get();
+		if (!History.Actor.IsValid() || !Capsule || History.Actor->IsPendingKill()) continue;
+
+		// Nothing recorded yet (or asking about the future), use where they are now
+		if (History.Count == 0 || Time >= History.Samples[History.Head].Time)
+		{
+			Out.Add(MakeCapsule(History, Capsule->GetComponentLocation(), Capsule->GetComponentQuat()));
+			continue;
+		}
+
+		// Walk back from newest until we straddle Time
+		int32 Newer = History.Head;
+		bool bFound = false;
+
+		for (int32 i = 1; i < History.Count; ++i)
+		{
+			const int32 Older = (History.Head - i + HistorySize) % HistorySize;
+			const auto& OlderSample = History.Samples[Older];
+
+			if (OlderSample.Time <= Time)
+			{
+				const auto& NewerSample = History.Samples[Newer];
+				const float Span = NewerSample.Time - OlderSample.Time;
+				const float Alpha = Span > SMALL_NUMBER ? (Time - OlderSample.Time) / Span : 1.f;
+
+				Out.Add(MakeCapsule(History,
+					FMath::Lerp(OlderSample.Center, NewerSample.Center, Alpha),
+					FQuat::Slerp(OlderSample.Rotation, NewerSample.Rotation, Alpha)));
+
+				bFound = true;
+				break;
+			}
+
+			Newer = Older;
+		}
+
+		// Older than our history, use the oldest we've got
+		if (!bFound)
+		{
+			const auto& Oldest = History.Samples[Newer];
+			Out.Add(MakeCapsule(History, Oldest.Center, Oldest.Rotation));
+		}
+	}
+}
+
+FRewoundCapsule ULagCompensationComponent::MakeCapsule(const FHistory& History, const FVector& Center, const FQuat& Rotation)
+{
+	const auto Capsule = History.Capsule.Get();
+	const float Radius = Capsule->GetScaledCapsuleRadius();
+	const float HalfSegment = FMath::Max(0.f, Capsule->GetScaledCapsuleHalfHeight() - Radius);
+	const FVector Up = Rotation.GetUpVector();
+
+	FRewoundCapsule Result;
+	Result.Actor = History.Actor;
+	Result.Bottom = Center - Up * HalfSegment;
+	Result.Top = Center + Up * HalfSegment;
+	Result.Radius = Radius;
+	return Result;
+}
@@ -0,0 +1,82 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+
+#include "LagCompensationComponent.generated.h"
+
+class APlayerState;
+class UCapsuleComponent;
+
+// A hero capsule at a point in time, as a segment plus radius
+struct FRewoundCapsule
+{
+	TWeakObjectPtr<AActor> Actor;
+	FVector Bottom;
+	FVector Top;
+	float Radius;
+};
+
+/**
+ * Records where every hero's capsule was for the last second or so, so hit tests can be run against
+ * the world as the shooter saw it. Fixed size ring buffers - nothing is allocated after BeginPlay. [Server]
+ */
+UCLASS(ClassGroup = (Custom))
+class MEATREALM_API ULagCompensationComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	// Upper bound on how far back (seconds) a shot may rewind targets. High ping players get this at most.
+	UPROPERTY(EditAnywhere)
+		float MaxRewindTime = 0.2f;
+
+	// Most actors that can be tracked at once
+	UPROPERTY(EditDefaultsOnly)
+		int32 MaxTrackedActors = 64;
+
+	// Samples kept per actor. One is taken every server tick.
+	static const int32 HistorySize = 64;
+
+private:
+	struct FSample
+	{
+		float Time;
+		FVector Center;
+		FQuat Rotation;
+	};
+
+	struct FHistory
+	{
+		TWeakObjectPtr<AActor> Actor;
+		TWeakObjectPtr<UCapsuleComponent> Capsule;
+		FSample Samples[HistorySize];
+		int32 Head = 0; // Index of the newest sample
+		int32 Count = 0;
+	};
+
+	TArray<FHistory> Histories;
+
+
+public:
+	ULagCompensationComponent();
+	static ULagCompensationComponent* Get(const UWorld* World);
+
+	void Register(AActor* Actor, UCapsuleComponent* Capsule);
+	void Unregister(AActor* Actor);
+
+	// How far back to look for a shot from this player
+	float GetRewindTime(const APlayerState* Shooter) const;
+
+	// Capsules of every tracked actor as they were at Time (world seconds). Out is reset, not reallocated.
+	void GetCapsulesAt(float Time, TArray<FRewoundCapsule>& Out) const;
+
+protected:
+	void BeginPlay() override;
+	void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+private:
+	static FRewoundCapsule MakeCapsule(const FHistory& History, const FVector& Center, const FQuat& Rotation);
+};
@@ -3,3 +3,7 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "Stats/Stats.h"
+
+// Runtime counters for the game's hot paths. View in game with "stat MeatRealm"
+DECLARE_STATS_GROUP(TEXT("MeatRealm"), STATGROUP_MeatRealm, STATCAT_Advanced);
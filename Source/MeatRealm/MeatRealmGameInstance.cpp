@@ -6,9 +6,20 @@
 #include "GameFramework/PlayerController.h"
 #include "Engine/ObjectLibrary.h"
 #include "DeathmatchGameMode.h"
+#include "WeaponReceiverComponent.h"
+#include "UObjectIterator.h"
+#include "GameplayClock.h"
+#include "InteractableRegistryComponent.h"
+#include "DeathmatchGameState.h"
 #include "FileManager.h"
 #include "Paths.h"
 
+void UMeatRealmGameInstance::Init()
+{
+	Super::Init();
+	FGameplayClock::InitFromCommandLine();
+}
+
 void UMeatRealmGameInstance::Host(const FString& MapName)
 {
 	//WriteDebugToScreen(FString("Host: " + MapName));
@@ -54,6 +65,51 @@ void UMeatRealmGameInstance::Join(const FString& ipaddress)
 	pc->ClientTravel(ipaddress, ETravelType::TRAVEL_Absolute);
 }
 
+void UMeatRealmGameInstance::DumpWeaponRecorders()
+{
+	const auto World = GetWorld();
+
+	int Count = 0;
+	for (TObjectIterator<UWeaponReceiverComponent> It; It; ++It)
+	{
+		if (It->GetWorld() != World || It->IsTemplate()) continue;
+
+		It->DumpFlightRecorder();
+		++Count;
+	}
+
+	WriteDebugToScreen(FString::Printf(TEXT("Dumped %d weapon recorders to the log"), Count));
+}
+
+void UMeatRealmGameInstance::FixedStep(float StepsPerSecond)
+{
+	FGameplayClock::SetFixedStep(StepsPerSecond);
+}
+
+void UMeatRealmGameInstance::TopDownMovement(bool bEnable)
+{
+	const auto World = GetWorld();
+	const auto GameState = World ? World->GetGameState<ADeathmatchGameState>() : nullptr;
+	if (!GameState) return;
+
+	// Replicated from the game state, so both ends of every move use the same mode
+	if (!GameState->HasAuthority())
+	{
+		WriteDebugToScreen(TEXT("Top down movement can only be changed on the server"), FColor::Red);
+		return;
+	}
+
+	GameState->SetUseTopDownMovement(bEnable);
+
+	WriteDebugToScreen(FString::Printf(TEXT("Top down movement %s"), bEnable ? TEXT("on") : TEXT("off")));
+}
+
+void UMeatRealmGameInstance::BenchInteractables(int32 NumPickups, int32 NumQueries)
+{
+	UInteractableRegistryComponent::Benchmark(NumPickups, NumQueries);
+	WriteDebugToScreen(TEXT("Interactable benchmark written to the log"));
+}
+
 void UMeatRealmGameInstance::WriteDebugToScreen(FString message, FColor color, float time, int key) const
 {
 	UEngine* gEngine = GetEngine();
@@ -12,6 +12,8 @@ class MEATREALM_API UMeatRealmGameInstance : public UGameInstance
 	GENERATED_BODY()
 
 public:
+	void Init() override;
+
 	UFUNCTION(Exec)
 	void Host(const FString& MapName);
 
@@ -24,6 +26,23 @@ public:
 	UFUNCTION(Exec)
 	void Join(const FString& ipaddress);
 
+	// Logs the recent state machine history of every weapon in the world
+	UFUNCTION(Exec)
+	void DumpWeaponRecorders();
+
+	// Run the game clock in fixed steps, as fast as frames can be simulated. 0 goes back to real time.
+	UFUNCTION(Exec)
+	void FixedStep(float StepsPerSecond);
+
+	// Switch every hero between full walking physics and flat ground top down movement. Compare with 'stat MeatRealm'.
+	// Server only, clients get it through the game state.
+	UFUNCTION(Exec)
+	void TopDownMovement(bool bEnable);
+
+	// Times finding the nearest interactable among NumPickups spread over a map sized area
+	UFUNCTION(Exec)
+	void BenchInteractables(int32 NumPickups = 500, int32 NumQueries = 10000);
+
 private:
 
 	void WriteDebugToScreen(FString message, FColor color = FColor::Blue, 
@@ -3,42 +3,319 @@
 
 #include "MeatyCharacterMovementComponent.h"
 #include "HeroCharacter.h"
+#include "DeathmatchGameState.h"
+#include "Engine/World.h"
 #include "Engine/Public/DrawDebugHelpers.h"
+#include "MeatRealm.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Movement Corrections"), STAT_MovementCorrections, STATGROUP_MeatRealm);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Movement Corrections Last Minute"), STAT_MovementCorrectionsLastMinute, STATGROUP_MeatRealm);
+DECLARE_CYCLE_STAT(TEXT("Movement Walking"), STAT_MovementWalking, STATGROUP_MeatRealm);
+DECLARE_CYCLE_STAT(TEXT("Movement Top Down"), STAT_MovementTopDown, STATGROUP_MeatRealm);
+
+UMeatyCharacterMovementComponent::UMeatyCharacterMovementComponent()
+{
+	bWantsToRun = false;
+	bWantsToTarget = false;
+}
+
+void UMeatyCharacterMovementComponent::SetUpdatedComponent(USceneComponent* NewUpdatedComponent)
+{
+	Super::SetUpdatedComponent(NewUpdatedComponent);
+	HeroOwner = Cast<AHeroCharacter>(PawnOwner);
+}
+
+void UMeatyCharacterMovementComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (HeroOwner)
+	{
+		RunningSpeed = HeroOwner->GetRunningSpeed();
+		RunningReloadSpeed = HeroOwner->GetRunningReloadSpeed();
+		HealingSpeed = HeroOwner->GetHealingMovementSpeed();
+	}
+
+	// Switched on for the whole match. Server and clients must agree or every move gets corrected.
+	const auto GameState = GetWorld()->GetGameState<ADeathmatchGameState>();
+	if (GameState && GameState->UseTopDownMovement())
+	{
+		bUseTopDownMovement = true;
+	}
+}
+
+void UMeatyCharacterMovementComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	DEC_DWORD_STAT_BY(STAT_MovementCorrectionsLastMinute, CorrectionsLastWindow);
+	CorrectionsLastWindow = 0;
+
+	Super::EndPlay(EndPlayReason);
+}
 
 float UMeatyCharacterMovementComponent::GetMaxBrakingDeceleration() const
 {
+	if (IsTopDown()) return BrakingDecelerationWalking;
 	return Super::GetMaxBrakingDeceleration();
 }
 
 float UMeatyCharacterMovementComponent::GetMaxSpeed() const
 {
-	float MaxSpeed = Super::GetMaxSpeed();
+	// Top down stands in for walking
+	float MaxSpeed = IsTopDown() ? MaxWalkSpeed : Super::GetMaxSpeed();
+	if (!HeroOwner) return MaxSpeed;
 
-	const auto* HeroChar = Cast<AHeroCharacter>(PawnOwner);
+	if (bWantsToTarget)
+	{
+		MaxSpeed *= TargetingSpeedScale;
+	}
 
-	if (HeroChar)
+	if (bIsUsingItem)
 	{
-		if (HeroChar->IsTargeting())
-		{
-			MaxSpeed *= HeroChar->GetTargetingSpeedModifier();
-		}
+		MaxSpeed = HealingSpeed;
+	}
+	else if (bWantsToRun)
+	{
+		MaxSpeed = bIsReloading ? RunningReloadSpeed : RunningSpeed;
+	}
+
+	return MaxSpeed;
+}
 
-		if (HeroChar->IsUsingItem())
+void UMeatyCharacterMovementComponent::UpdateCharacterStateBeforeMovement(float DeltaSeconds)
+{
+	Super::UpdateCharacterStateBeforeMovement(DeltaSeconds);
+	if (!HeroOwner) return;
+
+	bIsReloading = HeroOwner->IsReloading();
+	bIsUsingItem = HeroOwner->IsUsingItem();
+	TargetingSpeedScale = HeroOwner->GetTargetingSpeedModifier();
+
+	// Part of the move, so replays and the server get the same result
+	MaxAcceleration = bWantsToRun ? RunningAcceleration : WalkingAcceleration;
+	BrakingFrictionFactor = bWantsToRun ? RunningBrakingFrictionFactor : WalkingBrakingFrictionFactor;
+	BrakingDecelerationWalking = bWantsToRun ? RunningBrakingDeceleration : WalkingBrakingDeceleration;
+}
+
+void UMeatyCharacterMovementComponent::UpdateFromCompressedFlags(uint8 Flags)
+{
+	Super::UpdateFromCompressedFlags(Flags);
+
+	bWantsToRun = (Flags & FSavedMove_Character::FLAG_Custom_0) != 0;
+	bWantsToTarget = (Flags & FSavedMove_Character::FLAG_Custom_1) != 0;
+
+	// The owning client also lands here when replaying saved moves after a correction. Those are old inputs, so only
+	// the server lets the hero catch up on whatever goes with the change.
+	if (HeroOwner && CharacterOwner->Role == ROLE_Authority)
+	{
+		if (HeroOwner->IsRunning() != bWantsToRun) HeroOwner->SetRunning(bWantsToRun);
+		if (HeroOwner->IsTargeting() != bWantsToTarget) HeroOwner->SetTargeting(bWantsToTarget);
+	}
+}
+
+bool UMeatyCharacterMovementComponent::IsMovingOnGround() const
+{
+	return Super::IsMovingOnGround() || (IsTopDown() && UpdatedComponent);
+}
+
+void UMeatyCharacterMovementComponent::SetUseTopDownMovement(bool bUse)
+{
+	bUseTopDownMovement = bUse;
+	if (!bUse && IsTopDown()) SetMovementMode(MOVE_Walking);
+}
+
+void UMeatyCharacterMovementComponent::OnMovementModeChanged(EMovementMode PreviousMovementMode, uint8 PreviousCustomMode)
+{
+	Super::OnMovementModeChanged(PreviousMovementMode, PreviousCustomMode);
+
+	if (IsTopDown() && UpdatedComponent)
+	{
+		LastFloorCheckLocation = UpdatedComponent->GetComponentLocation();
+	}
+}
+
+void UMeatyCharacterMovementComponent::PhysWalking(float DeltaTime, int32 Iterations)
+{
+	{
+		SCOPE_CYCLE_COUNTER(STAT_MovementWalking);
+		Super::PhysWalking(DeltaTime, Iterations);
+	}
+
+	// Back to the cheap path once we're on level ground again
+	if (bUseTopDownMovement && MovementMode == MOVE_Walking && IsFlatFloor(CurrentFloor))
+	{
+		SetMovementMode(MOVE_Custom, uint8(EMeatyMovementMode::TopDown));
+	}
+}
+
+void UMeatyCharacterMovementComponent::PhysCustom(float DeltaTime, int32 Iterations)
+{
+	if (CustomMovementMode == uint8(EMeatyMovementMode::TopDown))
+	{
+		PhysTopDown(DeltaTime, Iterations);
+		return;
+	}
+
+	Super::PhysCustom(DeltaTime, Iterations);
+}
+
+void UMeatyCharacterMovementComponent::PhysTopDown(float DeltaTime, int32 Iterations)
+{
+	SCOPE_CYCLE_COUNTER(STAT_MovementTopDown);
+
+	if (DeltaTime < MIN_TICK_TIME) return;
+
+	if (!CharacterOwner || (!CharacterOwner->Controller && !bRunPhysicsWithNoController && CharacterOwner->Role != ROLE_SimulatedProxy))
+	{
+		Acceleration = FVector::ZeroVector;
+		Velocity = FVector::ZeroVector;
+		return;
+	}
+
+	// Flat ground, so everything happens in the plane. The floor height is wherever we are.
+	Acceleration.Z = 0;
+	Velocity.Z = 0;
+	CalcVelocity(DeltaTime, GroundFriction, false, GetMaxBrakingDeceleration());
+
+	const FVector OldLocation = UpdatedComponent->GetComponentLocation();
+	const FVector Delta = Velocity * DeltaTime;
+	if (Delta.IsNearlyZero()) return;
+
+	// Starting inside something is dealt with by the move itself. One depenetration attempt, no step up.
+	FHitResult Hit(1.f);
+	SafeMoveUpdatedComponent(Delta, UpdatedComponent->GetComponentQuat(), true, Hit);
+
+	if (Hit.IsValidBlockingHit())
+	{
+		// Upright walls we can slide along. Anything sloped is a step or ramp, which walking knows how to deal with.
+		if (FMath::Abs(Hit.ImpactNormal.Z) > FlatNormalTolerance)
 		{
-			MaxSpeed = HeroChar->GetHealingMovementSpeed();
+			SetMovementMode(MOVE_Walking);
+			StartNewPhysics(DeltaTime * (1.f - Hit.Time), Iterations);
+			return;
 		}
-		else if (HeroChar->IsRunning())
+
+		SlideAlongSurface(Delta, 1.f - Hit.Time, Hit.Normal, Hit, true);
+	}
+
+	const FVector NewLocation = UpdatedComponent->GetComponentLocation();
+
+	// Only look down every so often. If the floor's gone or isn't flat any more let walking sort it out.
+	if (FVector::DistSquared2D(NewLocation, LastFloorCheckLocation) > FMath::Square(FloorRecheckDistance))
+	{
+		LastFloorCheckLocation = NewLocation;
+		FindFloor(NewLocation, CurrentFloor, false);
+
+		if (!IsFlatFloor(CurrentFloor))
 		{
-			if (HeroChar->IsReloading())
-			{
-				MaxSpeed = HeroChar->GetRunningReloadSpeed();
-			}
-			else
-			{
-				MaxSpeed = HeroChar->GetRunningSpeed();
-			}
+			SetMovementMode(MOVE_Walking);
+			return;
 		}
 	}
 
-	return MaxSpeed;
+	if (!bJustTeleported)
+	{
+		Velocity = (NewLocation - OldLocation) / DeltaTime;
+		Velocity.Z = 0;
+	}
+}
+
+bool UMeatyCharacterMovementComponent::IsFlatFloor(const FFindFloorResult& Floor) const
+{
+	return Floor.IsWalkableFloor()
+		&& Floor.HitResult.ImpactNormal.Z >= 1.f - FlatNormalTolerance
+		&& Floor.FloorDist <= MAX_FLOOR_DIST;
+}
+
+bool UMeatyCharacterMovementComponent::ServerCheckClientError(float ClientTimeStamp, float DeltaTime, const FVector& Accel,
+	const FVector& ClientLoc, const FVector& RelativeClientLoc, UPrimitiveComponent* ClientMovementBase, FName ClientBaseBoneName,
+	uint8 ClientMovementMode)
+{
+	const bool bNeedsCorrection = Super::ServerCheckClientError(ClientTimeStamp, DeltaTime, Accel, ClientLoc,
+		RelativeClientLoc, ClientMovementBase, ClientBaseBoneName, ClientMovementMode);
+
+	// Each hero swaps its own last minute in and out of the stat, which then sums every player on the server
+	const float Now = GetWorld()->GetTimeSeconds();
+	if (Now - CorrectionWindowStart >= 60)
+	{
+		DEC_DWORD_STAT_BY(STAT_MovementCorrectionsLastMinute, CorrectionsLastWindow);
+		INC_DWORD_STAT_BY(STAT_MovementCorrectionsLastMinute, CorrectionsThisWindow);
+		CorrectionsLastWindow = CorrectionsThisWindow;
+		CorrectionsThisWindow = 0;
+		CorrectionWindowStart = Now;
+	}
+
+	if (bNeedsCorrection)
+	{
+		++CorrectionsThisWindow;
+		INC_DWORD_STAT(STAT_MovementCorrections);
+	}
+
+	return bNeedsCorrection;
+}
+
+FNetworkPredictionData_Client* UMeatyCharacterMovementComponent::GetPredictionData_Client() const
+{
+	if (!ClientPredictionData)
+	{
+		auto MutableThis = const_cast<UMeatyCharacterMovementComponent*>(this);
+		MutableThis->ClientPredictionData = new FNetworkPredictionData_Client_Meaty(*this);
+	}
+
+	return ClientPredictionData;
+}
+
+
+/// Saved moves
+
+void FSavedMove_Meaty::Clear()
+{
+	Super::Clear();
+	bSavedWantsToRun = false;
+	bSavedWantsToTarget = false;
+}
+
+uint8 FSavedMove_Meaty::GetCompressedFlags() const
+{
+	uint8 Flags = Super::GetCompressedFlags();
+	if (bSavedWantsToRun) Flags |= FLAG_Custom_0;
+	if (bSavedWantsToTarget) Flags |= FLAG_Custom_1;
+	return Flags;
+}
+
+bool FSavedMove_Meaty::CanCombineWith(const FSavedMovePtr& NewMove, ACharacter* InCharacter, float MaxDelta) const
+{
+	const auto Other = static_cast<FSavedMove_Meaty*>(NewMove.Get());
+	if (bSavedWantsToRun != Other->bSavedWantsToRun) return false;
+	if (bSavedWantsToTarget != Other->bSavedWantsToTarget) return false;
+
+	return Super::CanCombineWith(NewMove, InCharacter, MaxDelta);
+}
+
+void FSavedMove_Meaty::SetMoveFor(ACharacter* C, float InDeltaTime, FVector const& NewAccel, FNetworkPredictionData_Client_Character& ClientData)
+{
+	Super::SetMoveFor(C, InDeltaTime, NewAccel, ClientData);
+
+	const auto Movement = Cast<UMeatyCharacterMovementComponent>(C->GetCharacterMovement());
+	if (Movement)
+	{
+		bSavedWantsToRun = Movement->bWantsToRun;
+		bSavedWantsToTarget = Movement->bWantsToTarget;
+	}
+}
+
+void FSavedMove_Meaty::PrepMoveFor(ACharacter* C)
+{
+	Super::PrepMoveFor(C);
+
+	const auto Movement = Cast<UMeatyCharacterMovementComponent>(C->GetCharacterMovement());
+	if (Movement)
+	{
+		Movement->bWantsToRun = bSavedWantsToRun;
+		Movement->bWantsToTarget = bSavedWantsToTarget;
+	}
+}
+
+FSavedMovePtr FNetworkPredictionData_Client_Meaty::AllocateNewMove()
+{
+	return FSavedMovePtr(new FSavedMove_Meaty());
 }
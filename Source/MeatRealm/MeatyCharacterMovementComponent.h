@@ -6,13 +6,133 @@
 #include "GameFramework/CharacterMovementComponent.h"
 #include "MeatyCharacterMovementComponent.generated.h"
 
+class AHeroCharacter;
+
+// Values for CustomMovementMode when MovementMode is MOVE_Custom
+UENUM()
+enum class EMeatyMovementMode : uint8
+{
+	None = 0,
+	TopDown,
+};
+
 /**
- * 
+ * Running and targeting travel with each move, so client and server always agree on the speed a move was made at.
  */
 UCLASS()
 class MEATREALM_API UMeatyCharacterMovementComponent : public UCharacterMovementComponent
 {
 	GENERATED_BODY()
+
+	friend class FSavedMove_Meaty;
+
+public:
+	UPROPERTY(EditAnywhere, Category = "Character Movement: Running")
+		float RunningAcceleration = 1250;
+
+	UPROPERTY(EditAnywhere, Category = "Character Movement: Running")
+		float RunningBrakingFrictionFactor = 1;
+
+	UPROPERTY(EditAnywhere, Category = "Character Movement: Running")
+		float RunningBrakingDeceleration = 250;
+
+	UPROPERTY(EditAnywhere, Category = "Character Movement: Running")
+		float WalkingAcceleration = 3000;
+
+	UPROPERTY(EditAnywhere, Category = "Character Movement: Running")
+		float WalkingBrakingFrictionFactor = 2;
+
+	UPROPERTY(EditAnywhere, Category = "Character Movement: Running")
+		float WalkingBrakingDeceleration = 3000;
+
+	// Cheap flat ground movement. One sweep per move and a floor check every so often. Stairs and ramps go back to walking.
+	UPROPERTY(EditAnywhere, Category = "Character Movement: Top Down")
+		bool bUseTopDownMovement = false;
+
+	// How far (cm) we can go before checking the floor is still there and still flat
+	UPROPERTY(EditAnywhere, Category = "Character Movement: Top Down", meta = (EditCondition = "bUseTopDownMovement"))
+		float FloorRecheckDistance = 40;
+
+	// Floors and walls must be this close to level/upright. Anything else is a ramp or a step.
+	UPROPERTY(EditAnywhere, Category = "Character Movement: Top Down", meta = (EditCondition = "bUseTopDownMovement"))
+		float FlatNormalTolerance = 0.01f;
+
+private:
+	// Predicted. Set locally then sent up with each move.
+	uint8 bWantsToRun : 1;
+	uint8 bWantsToTarget : 1;
+
+	AHeroCharacter* HeroOwner = nullptr;
+
+	// Speed inputs. Config is copied once, state is refreshed once per move rather than on every GetMaxSpeed.
+	float RunningSpeed = 0;
+	float RunningReloadSpeed = 0;
+	float HealingSpeed = 0;
+	float TargetingSpeedScale = 1;
+	bool bIsReloading = false;
+	bool bIsUsingItem = false;
+
+	// Where the floor under us was last checked in top down mode
+	FVector LastFloorCheckLocation = FVector::ZeroVector;
+
+	// Corrections sent to this hero, in whole minute windows of world time. The last full window is added into the stat.
+	float CorrectionWindowStart = 0;
+	uint32 CorrectionsThisWindow = 0;
+	uint32 CorrectionsLastWindow = 0;
+
+
+public:
+	UMeatyCharacterMovementComponent();
+
+	void SetWantsToRun(bool bNewWantsToRun) { bWantsToRun = bNewWantsToRun; }
+	void SetWantsToTarget(bool bNewWantsToTarget) { bWantsToTarget = bNewWantsToTarget; }
+
+	bool IsTopDown() const { return MovementMode == MOVE_Custom && CustomMovementMode == uint8(EMeatyMovementMode::TopDown); }
+	void SetUseTopDownMovement(bool bUse);
+	bool IsMovingOnGround() const override;
+
+	void SetUpdatedComponent(USceneComponent* NewUpdatedComponent) override;
 	float GetMaxBrakingDeceleration() const override;
 	float GetMaxSpeed() const override;
+	FNetworkPredictionData_Client* GetPredictionData_Client() const override;
+
+protected:
+	void BeginPlay() override;
+	void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+	void UpdateFromCompressedFlags(uint8 Flags) override;
+	void UpdateCharacterStateBeforeMovement(float DeltaSeconds) override;
+	void OnMovementModeChanged(EMovementMode PreviousMovementMode, uint8 PreviousCustomMode) override;
+	void PhysWalking(float DeltaTime, int32 Iterations) override;
+	void PhysCustom(float DeltaTime, int32 Iterations) override;
+	bool ServerCheckClientError(float ClientTimeStamp, float DeltaTime, const FVector& Accel, const FVector& ClientLoc,
+		const FVector& RelativeClientLoc, UPrimitiveComponent* ClientMovementBase, FName ClientBaseBoneName, uint8 ClientMovementMode) override;
+
+private:
+	void PhysTopDown(float DeltaTime, int32 Iterations);
+	bool IsFlatFloor(const FFindFloorResult& Floor) const;
+};
+
+class FSavedMove_Meaty : public FSavedMove_Character
+{
+	typedef FSavedMove_Character Super;
+
+public:
+	uint8 bSavedWantsToRun : 1;
+	uint8 bSavedWantsToTarget : 1;
+
+	void Clear() override;
+	uint8 GetCompressedFlags() const override;
+	bool CanCombineWith(const FSavedMovePtr& NewMove, ACharacter* InCharacter, float MaxDelta) const override;
+	void SetMoveFor(ACharacter* C, float InDeltaTime, FVector const& NewAccel, FNetworkPredictionData_Client_Character& ClientData) override;
+	void PrepMoveFor(ACharacter* C) override;
+};
+
+class FNetworkPredictionData_Client_Meaty : public FNetworkPredictionData_Client_Character
+{
+	typedef FNetworkPredictionData_Client_Character Super;
+
+public:
+	FNetworkPredictionData_Client_Meaty(const UCharacterMovementComponent& ClientMovement) : Super(ClientMovement) {}
+
+	FSavedMovePtr AllocateNewMove() override;
 };
@@ -5,6 +5,7 @@
 #include "Components/SceneComponent.h"
 #include "TimerManager.h"
 #include "UnrealNetwork.h"
+#include "InteractableRegistryComponent.h"
 
 void APickupBase::GetLifetimeReplicatedProps(TArray< FLifetimeProperty >& OutLifetimeProps) const
 {
@@ -32,6 +33,22 @@ APickupBase::APickupBase()
 	SkeletalMeshComp->CanCharacterStepUpOn = ECB_No;
 }
 
+void APickupBase::BeginPlay()
+{
+	Super::BeginPlay();
+
+	auto Registry = UInteractableRegistryComponent::Get(GetWorld());
+	if (Registry) Registry->Register(this);
+}
+
+void APickupBase::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	auto Registry = UInteractableRegistryComponent::Get(GetWorld());
+	if (Registry) Registry->Unregister(this);
+
+	Super::EndPlay(EndPlayReason);
+}
+
 bool APickupBase::AuthTryInteract(IAffectableInterface* const Affectable)
 {
 	check(Affectable)
@@ -123,6 +140,9 @@ void APickupBase::Respawn()
 void APickupBase::MakePickupAvailable(bool bIsAvailable)
 {
 	//LogMsgWithRole("APickupBase::MakePickupAvailable()");
+	auto Registry = UInteractableRegistryComponent::Get(GetWorld());
+	if (Registry) Registry->SetAvailable(this, bIsAvailable);
+
 	if (bIsAvailable)
 	{
 		// Show visual
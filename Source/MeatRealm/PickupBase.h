@@ -70,8 +70,12 @@ public:
 	}
 	bool AuthTryInteract(IAffectableInterface* const Affectable);
 	FString GetPickupName() const { return NiceName; }
+	bool IsExplicitInteraction() const { return bExplicitInteraction; }
+	bool GetIsAvailable() const { return IsAvailable; }
 
 protected:
+	void BeginPlay() override;
+	void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
 	// Override this to do whatever.
 	virtual bool TryApplyAffect(IAffectableInterface* const Affectable)
@@ -6,7 +6,9 @@
 #include "Components/SphereComponent.h"
 #include "GameFramework/ProjectileMovementComponent.h"
 #include "GameFramework/Controller.h"
+#include "UnrealNetwork.h"
 #include "PickupBase.h"
+#include "ProjectilePoolComponent.h"
 
 
 // Sets default values
@@ -42,16 +44,129 @@ AProjectile::AProjectile()
 	// TODO Show a billboard if by default on the placeholder
 }
 
+void AProjectile::GetLifetimeReplicatedProps(TArray< FLifetimeProperty >& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+	DOREPLIFETIME(AProjectile, Launch);
+}
+
 
 void AProjectile::FireInDirection(const FVector& ShootDirection)
 {
-	ProjectileMovementComp->Velocity	= ShootDirection * ProjectileMovementComp->InitialSpeed;
+	StartMovement(ShootDirection);
+
+	if (HasAuthority())
+	{
+		Launch.Origin = GetActorLocation();
+		Launch.Direction = ShootDirection;
+		Launch.bInFlight = true;
+		++Launch.LaunchCount;
+	}
+}
+
+float AProjectile::GetSpeed() const
+{
+	return ProjectileMovementComp ? ProjectileMovementComp->InitialSpeed : 0.f;
+}
+
+float AProjectile::GetCollisionRadius() const
+{
+	return CollisionComp ? CollisionComp->GetScaledSphereRadius() : 0.f;
+}
+
+
+/// Pooling
+
+void AProjectile::ActivateFromPool(const FTransform& Tform)
+{
+	check(HasAuthority());
+
+	SetNetDormancy(DORM_Awake);
+	SetActorTransform(Tform, false, nullptr, ETeleportType::ResetPhysics);
+	SetInFlight(true);
+	SetLifeSpan(InitialLifeSpan);
+	ForceNetUpdate();
+}
+
+void AProjectile::DeactivateToPool()
+{
+	check(HasAuthority());
+
+	SetInFlight(false);
+	SetLifeSpan(0);
+	SetOwner(nullptr);
+	Instigator = nullptr;
+	Launch.bInFlight = false;
+
+	// Sends the parked state once then stops considering us for replication until reused
+	SetNetDormancy(DORM_DormantAll);
+}
+
+void AProjectile::LifeSpanExpired()
+{
+	if (!HasAuthority())
+	{
+		Super::LifeSpanExpired();
+		return;
+	}
+
+	Expire();
+}
+
+void AProjectile::Expire()
+{
+	check(HasAuthority());
+
+	auto Pool = OwningPool.Get();
+	if (Pool)
+	{
+		Pool->Release(this);
+	}
+	else
+	{
+		Destroy();
+	}
+}
+
+void AProjectile::SetInFlight(bool bInFlight)
+{
+	SetActorHiddenInGame(!bInFlight);
+	SetActorEnableCollision(bInFlight);
+	SetActorTickEnabled(bInFlight);
+
+	if (!bInFlight)
+	{
+		ProjectileMovementComp->StopMovementImmediately();
+		ProjectileMovementComp->SetComponentTickEnabled(false);
+	}
+}
+
+void AProjectile::StartMovement(const FVector& Direction)
+{
+	// A stopped movement comp forgets what it was moving. Put it back.
+	ProjectileMovementComp->SetUpdatedComponent(CollisionComp);
+	ProjectileMovementComp->Velocity = Direction * ProjectileMovementComp->InitialSpeed;
+	ProjectileMovementComp->UpdateComponentVelocity();
+	ProjectileMovementComp->SetComponentTickEnabled(true);
+}
+
+void AProjectile::OnRep_Launch()
+{
+	if (!Launch.bInFlight)
+	{
+		SetInFlight(false);
+		return;
+	}
+
+	SetActorLocationAndRotation(Launch.Origin, Launch.Direction.Rotation(), false, nullptr, ETeleportType::ResetPhysics);
+	SetInFlight(true);
+	StartMovement(Launch.Direction);
 }
 
 void AProjectile::OnCompHit(UPrimitiveComponent* HitComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp,
 	FVector NormalImpulse, const FHitResult& Hit)
 {
-	if (!HasAuthority()) { return; }
+	if (!HasAuthority() || !Launch.bInFlight) { return; }
 	
 	//UE_LOG(LogTemp, Warning, TEXT("AProjectile::OnCompHit()"));
 
@@ -60,7 +175,7 @@ void AProjectile::OnCompHit(UPrimitiveComponent* HitComponent, AActor* OtherActo
 	{
 		UE_LOG(LogTemp, Error, TEXT("AProjectile::OnCompHit() - WASTED HIT, OPTIMISE ME OUT WITH CHANNEL"));
 
-		Destroy();
+		Expire();
 
 		return;
 	}
@@ -73,7 +188,7 @@ void AProjectile::OnCompHit(UPrimitiveComponent* HitComponent, AActor* OtherActo
 		OtherComp->AddImpulseAtLocation(ImpulseFactor * GetVelocity(), GetActorLocation());
 	}
 
-	Destroy();
+	Expire();
 }
 
 
@@ -82,7 +197,7 @@ void AProjectile::OnCompBeginOverlap(UPrimitiveComponent* OverlappedComp, AActor
 {
 	//UE_LOG(LogTemp, Warning, TEXT("AProjectile::OnCompBeginOverlap()"));
 
-	if (!HasAuthority()) return;
+	if (!HasAuthority() || !Launch.bInFlight) return;
 
 	const auto TheReceiver = OtherActor;
 
@@ -103,5 +218,5 @@ void AProjectile::OnCompBeginOverlap(UPrimitiveComponent* OverlappedComp, AActor
 		AffectableReceiver->AuthApplyDamage(HeroControllerId, ShotDamage, GetActorLocation());
 	}
 	
-	Destroy();
+	Expire();
 }
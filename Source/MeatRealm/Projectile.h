@@ -4,12 +4,34 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
+#include "Engine/NetSerialization.h"
 
 #include "Projectile.generated.h"
 
 class USphereComponent;
 class UStaticMeshComponent;
 class UProjectileMovementComponent;
+class UProjectilePoolComponent;
+
+// Everything a client needs to put a recycled projectile back into flight
+USTRUCT()
+struct FProjectileLaunch
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+		FVector_NetQuantize Origin;
+
+	UPROPERTY()
+		FVector_NetQuantizeNormal Direction;
+
+	// Bumped every launch so back to back launches from the same spot still replicate
+	UPROPERTY()
+		uint8 LaunchCount = 0;
+
+	UPROPERTY()
+		bool bInFlight = false;
+};
 
 UCLASS()
 class MEATREALM_API AProjectile : public AActor
@@ -34,6 +56,19 @@ public:
 	UFUNCTION()
 	void OnCompBeginOverlap(UPrimitiveComponent* OverlappedComp, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult);
 
+	/// Pooling [Server]
+	void SetPool(UProjectilePoolComponent* Pool) { OwningPool = Pool; }
+	void ActivateFromPool(const FTransform& Tform);
+	void DeactivateToPool();
+	bool IsInFlight() const { return Launch.bInFlight; }
+
+	float GetSpeed() const;
+	float GetCollisionRadius() const;
+	UStaticMeshComponent* GetMeshComp() const { return MeshComp; }
+
+protected:
+	void LifeSpanExpired() override;
+
 private:
 	UPROPERTY(VisibleAnywhere)
 		UStaticMeshComponent* MeshComp = nullptr;
@@ -44,4 +79,16 @@ private:
 	UPROPERTY(VisibleAnywhere, Category = Movement)
 		UProjectileMovementComponent* ProjectileMovementComp;
 
+	UPROPERTY(ReplicatedUsing = OnRep_Launch)
+		FProjectileLaunch Launch;
+
+	TWeakObjectPtr<UProjectilePoolComponent> OwningPool = nullptr;
+
+	UFUNCTION()
+		void OnRep_Launch();
+
+	// Return to the pool if we have one, otherwise destroy like a regular actor
+	void Expire();
+	void SetInFlight(bool bInFlight);
+	void StartMovement(const FVector& Direction);
 };
@@ -0,0 +1,397 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ProjectileManagerComponent.h"
+#include "Components/CapsuleComponent.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Components/StaticMeshComponent.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "GameFramework/GameStateBase.h"
+#include "HeroCharacter.h"
+#include "Interfaces/AffectableInterface.h"
+#include "MeatRealm.h"
+#include "GameplayClock.h"
+#include "Projectile.h"
+
+DECLARE_CYCLE_STAT(TEXT("Batched Projectiles Tick"), STAT_BatchedProjectilesTick, STATGROUP_MeatRealm);
+DECLARE_CYCLE_STAT(TEXT("Hitscan Resolve"), STAT_HitscanResolve, STATGROUP_MeatRealm);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Batched Projectiles"), STAT_BatchedProjectiles, STATGROUP_MeatRealm);
+
+
+FBatchedProjectileDesc FBatchedProjectileDesc::FromClass(TSubclassOf<AProjectile> ProjectileClass)
+{
+	FBatchedProjectileDesc Desc{};
+	if (!ProjectileClass) return Desc;
+
+	const auto Defaults = ProjectileClass->GetDefaultObject<AProjectile>();
+	if (!Defaults) return Desc;
+
+	Desc.Speed = Defaults->GetSpeed();
+	Desc.Radius = Defaults->GetCollisionRadius();
+	Desc.Damage = Defaults->ShotDamage;
+	Desc.LifeSpan = Defaults->InitialLifeSpan;
+
+	const auto MeshComp = Defaults->GetMeshComp();
+	if (MeshComp)
+	{
+		Desc.Mesh = MeshComp->GetStaticMesh();
+		Desc.MeshScale = MeshComp->RelativeScale3D;
+	}
+
+	return Desc;
+}
+
+
+UProjectileManagerComponent::UProjectileManagerComponent()
+{
+	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.bStartWithTickEnabled = false;
+}
+
+UProjectileManagerComponent* UProjectileManagerComponent::Get(const UWorld* World)
+{
+	if (!World) return nullptr;
+
+	const auto GameState = World->GetGameState();
+	return GameState ? GameState->FindComponentByClass<UProjectileManagerComponent>() : nullptr;
+}
+
+void UProjectileManagerComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	RemoveAll();
+	Super::EndPlay(EndPlayReason);
+}
+
+void UProjectileManagerComponent::SpawnProjectile(const FBatchedProjectileDesc& Desc, const FVector& Origin,
+	const FVector& Direction, uint32 OwnerId, AActor* Instigator, float Age, float RewindTime)
+{
+	const FVector Velocity = Direction * Desc.Speed;
+
+	Locations.Add(Origin + Velocity * Age);
+	Velocities.Add(Velocity);
+	Radii.Add(Desc.Radius);
+	OwnerIds.Add(OwnerId);
+	Damages.Add(Desc.Damage);
+	SpawnTimes.Add(FGameplayClock::LocalNow(GetWorld()) - Age);
+	LifeSpans.Add(Desc.LifeSpan);
+	Instigators.Add(Instigator);
+	RewindSteps.Add(RewindStep > 0.f ? FMath::RoundToInt(RewindTime / RewindStep) : 0);
+	RenderGroups.Add(FindOrAddRenderGroup(Desc.Mesh, Desc.MeshScale));
+
+	SetComponentTickEnabled(true);
+}
+
+void UProjectileManagerComponent::TickComponent(float DeltaTime, ELevelTick TickType,
+	FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	SCOPE_CYCLE_COUNTER(STAT_BatchedProjectilesTick);
+
+	if (Locations.Num() > 0)
+	{
+		SnapshotIndexByStep.Reset();
+		Simulate(DeltaTime, GetOwner()->HasAuthority());
+	}
+
+	UpdateRendering();
+
+	SET_DWORD_STAT(STAT_BatchedProjectiles, Locations.Num());
+
+	// Nothing left to fly, sleep until the next shot
+	if (Locations.Num() == 0) SetComponentTickEnabled(false);
+}
+
+const TArray<FRewoundCapsule>& UProjectileManagerComponent::GetSnapshot(int32 Step, bool bIsAuthoritative)
+{
+	// Clients don't rewind, everything shares the one snapshot of now
+	const int32 Key = bIsAuthoritative ? Step : 0;
+
+	if (const int32* Found = SnapshotIndexByStep.Find(Key))
+	{
+		return Snapshots[*Found];
+	}
+
+	const int32 Index = SnapshotIndexByStep.Num();
+	if (Index == Snapshots.Num()) Snapshots.AddDefaulted();
+	SnapshotIndexByStep.Add(Key, Index);
+
+	auto& Snapshot = Snapshots[Index];
+
+	const auto LagComp = bIsAuthoritative ? ULagCompensationComponent::Get(GetWorld()) : nullptr;
+	if (LagComp)
+	{
+		LagComp->GetCapsulesAt(FGameplayClock::LocalNow(GetWorld()) - Key * RewindStep, Snapshot);
+	}
+	else
+	{
+		GatherCurrentCapsules(Snapshot);
+	}
+
+	return Snapshot;
+}
+
+void UProjectileManagerComponent::GatherCurrentCapsules(TArray<FRewoundCapsule>& Out) const
+{
+	Out.Reset();
+
+	for (TActorIterator<AHeroCharacter> It(GetWorld()); It; ++It)
+	{
+		AHeroCharacter* Hero = *It;
+		if (!Hero || Hero->IsPendingKill()) continue;
+
+		const auto Capsule = Hero->GetCapsuleComponent();
+		if (!Capsule) continue;
+
+		const float Radius = Capsule->GetScaledCapsuleRadius();
+		const float HalfSegment = FMath::Max(0.f, Capsule->GetScaledCapsuleHalfHeight() - Radius);
+		const FVector Center = Capsule->GetComponentLocation();
+		const FVector Up = Capsule->GetUpVector();
+
+		FRewoundCapsule Entry;
+		Entry.Actor = Hero;
+		Entry.Bottom = Center - Up * HalfSegment;
+		Entry.Top = Center + Up * HalfSegment;
+		Entry.Radius = Radius;
+		Out.Add(Entry);
+	}
+}
+
+void UProjectileManagerComponent::Simulate(float DeltaTime, bool bIsAuthoritative)
+{
+	const float Now = FGameplayClock::LocalNow(GetWorld());
+
+	// Iterate backwards so finished projectiles can be swapped out in place
+	for (int32 i = Locations.Num() - 1; i >= 0; --i)
+	{
+		if (Now - SpawnTimes[i] > LifeSpans[i])
+		{
+			RemoveProjectile(i);
+			continue;
+		}
+
+		const FVector Start = Locations[i];
+		const FVector End = Start + Velocities[i] * DeltaTime;
+		const auto& Capsules = GetSnapshot(RewindSteps[i], bIsAuthoritative);
+
+		FSegmentHit Hit{};
+		if (TraceSegment(Start, End, Radii[i], Instigators[i].Get(), Capsules, Hit))
+		{
+			if (bIsAuthoritative) ApplyHit(Hit, ImpulseFactor * Velocities[i], OwnerIds[i], Damages[i]);
+
+			RemoveProjectile(i);
+			continue;
+		}
+
+		Locations[i] = End;
+	}
+}
+
+void UProjectileManagerComponent::ResolveHitscan(const FVector& Origin, TArrayView<const FVector> Directions, float Range,
+	float Damage, uint32 OwnerId, AActor* Instigator, float RewindTime, bool bIsAuthoritative, TArray<FVector>& OutEnds)
+{
+	SCOPE_CYCLE_COUNTER(STAT_HitscanResolve);
+
+	OutEnds.Reset();
+
+	// Every pellet in the pull shares the one snapshot
+	const auto LagComp = bIsAuthoritative ? ULagCompensationComponent::Get(GetWorld()) : nullptr;
+	if (LagComp)
+	{
+		LagComp->GetCapsulesAt(FGameplayClock::LocalNow(GetWorld()) - RewindTime, HitscanCapsules);
+	}
+	else
+	{
+		GatherCurrentCapsules(HitscanCapsules);
+	}
+
+	for (const auto& Direction : Directions)
+	{
+		const FVector End = Origin + Direction * Range;
+
+		FSegmentHit Hit{};
+		if (TraceSegment(Origin, End, 0.f, Instigator, HitscanCapsules, Hit))
+		{
+			if (bIsAuthoritative) ApplyHit(Hit, HitscanImpulse * Direction, OwnerId, Damage);
+			OutEnds.Add(Hit.Location);
+		}
+		else
+		{
+			OutEnds.Add(End);
+		}
+	}
+}
+
+bool UProjectileManagerComponent::TraceSegment(const FVector& Start, const FVector& End, float Radius,
+	const AActor* Instigator, const TArray<FRewoundCapsule>& Capsules, FSegmentHit& OutHit) const
+{
+	const float SegmentLength = FVector::Dist(Start, End);
+
+	// Closest hero capsule along the segment
+	int32 HitCapsule = INDEX_NONE;
+	float HitCapsuleDist = MAX_flt;
+	FVector HitCapsuleLocation{};
+
+	for (int32 c = 0; c < Capsules.Num(); ++c)
+	{
+		const auto& Capsule = Capsules[c];
+		if (Capsule.Actor.Get() == Instigator) continue;
+
+		FVector OnCapsule, OnSegment;
+		FMath::SegmentDistToSegmentSafe(Capsule.Bottom, Capsule.Top, Start, End, OnCapsule, OnSegment);
+
+		const float Reach = Capsule.Radius + Radius;
+		if (FVector::DistSquared(OnCapsule, OnSegment) > Reach * Reach) continue;
+
+		const float Dist = FVector::Dist(Start, OnSegment);
+		if (Dist < HitCapsuleDist)
+		{
+			HitCapsule = c;
+			HitCapsuleDist = Dist;
+			HitCapsuleLocation = OnSegment;
+		}
+	}
+
+	// Projectiles pass through pawns (handled analytically above) and stop on everything solid
+	FCollisionObjectQueryParams WorldObjects{};
+	WorldObjects.AddObjectTypesToQuery(ECC_WorldStatic);
+	WorldObjects.AddObjectTypesToQuery(ECC_WorldDynamic);
+	WorldObjects.AddObjectTypesToQuery(ECC_PhysicsBody);
+	WorldObjects.AddObjectTypesToQuery(ECC_Destructible);
+
+	const FCollisionQueryParams QueryParams{ SCENE_QUERY_STAT(BatchedProjectile), false };
+
+	// World geometry - only worth tracing up to any hero we've already hit
+	const FVector TraceEnd = HitCapsule != INDEX_NONE && SegmentLength > 0
+		? FMath::Lerp(Start, End, HitCapsuleDist / SegmentLength)
+		: End;
+
+	// Swept with the projectile's radius so it stops on the same things the actor's collision sphere would
+	FHitResult WorldHit{};
+	const bool bHitWorld = Radius > 0
+		? GetWorld()->SweepSingleByObjectType(WorldHit, Start, TraceEnd, FQuat::Identity, WorldObjects, FCollisionShape::MakeSphere(Radius), QueryParams)
+		: GetWorld()->LineTraceSingleByObjectType(WorldHit, Start, TraceEnd, WorldObjects, QueryParams);
+
+	if (bHitWorld)
+	{
+		OutHit.Location = WorldHit.ImpactPoint;
+		OutHit.WorldComponent = WorldHit.GetComponent();
+		OutHit.Victim = nullptr;
+		return true;
+	}
+
+	if (HitCapsule != INDEX_NONE)
+	{
+		OutHit.Location = HitCapsuleLocation;
+		OutHit.WorldComponent = nullptr;
+		OutHit.Victim = Capsules[HitCapsule].Actor.Get();
+		return true;
+	}
+
+	return false;
+}
+
+void UProjectileManagerComponent::ApplyHit(const FSegmentHit& Hit, const FVector& Impulse, uint32 OwnerId, float Damage) const
+{
+	// If we hit a physics body, nudge it!
+	if (Hit.WorldComponent && Hit.WorldComponent->IsSimulatingPhysics())
+	{
+		Hit.WorldComponent->AddImpulseAtLocation(Impulse, Hit.Location);
+		return;
+	}
+
+	if (Hit.Victim && !Hit.Victim->IsPendingKill())
+	{
+		auto Affectable = Cast<IAffectableInterface>(Hit.Victim);
+		if (Affectable) Affectable->AuthApplyDamage(OwnerId, Damage, Hit.Location);
+	}
+}
+
+void UProjectileManagerComponent::RemoveProjectile(int32 Index)
+{
+	Locations.RemoveAtSwap(Index, 1, false);
+	Velocities.RemoveAtSwap(Index, 1, false);
+	Radii.RemoveAtSwap(Index, 1, false);
+	OwnerIds.RemoveAtSwap(Index, 1, false);
+	Damages.RemoveAtSwap(Index, 1, false);
+	SpawnTimes.RemoveAtSwap(Index, 1, false);
+	LifeSpans.RemoveAtSwap(Index, 1, false);
+	Instigators.RemoveAtSwap(Index, 1, false);
+	RewindSteps.RemoveAtSwap(Index, 1, false);
+	RenderGroups.RemoveAtSwap(Index, 1, false);
+}
+
+void UProjectileManagerComponent::RemoveAll()
+{
+	Locations.Reset();
+	Velocities.Reset();
+	Radii.Reset();
+	OwnerIds.Reset();
+	Damages.Reset();
+	SpawnTimes.Reset();
+	LifeSpans.Reset();
+	Instigators.Reset();
+	RewindSteps.Reset();
+	RenderGroups.Reset();
+	Snapshots.Reset();
+	SnapshotIndexByStep.Reset();
+}
+
+
+/// Rendering - one instanced mesh per projectile mesh, rebuilt from the live arrays each tick
+
+int32 UProjectileManagerComponent::FindOrAddRenderGroup(UStaticMesh* Mesh, const FVector& Scale)
+{
+	// Dedicated servers have nothing to look at
+	if (!Mesh || GetNetMode() == NM_DedicatedServer) return INDEX_NONE;
+
+	for (int32 i = 0; i < RenderGroupComps.Num(); ++i)
+	{
+		if (RenderGroupComps[i] && RenderGroupComps[i]->GetStaticMesh() == Mesh) return i;
+	}
+
+	auto Comp = NewObject<UInstancedStaticMeshComponent>(GetOwner());
+	Comp->SetStaticMesh(Mesh);
+	Comp->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	Comp->SetGenerateOverlapEvents(false);
+	Comp->SetCastShadow(false);
+	Comp->SetMobility(EComponentMobility::Movable);
+	Comp->RegisterComponent();
+
+	RenderGroupTransforms.AddDefaulted();
+	RenderGroupScales.Add(Scale);
+	return RenderGroupComps.Add(Comp);
+}
+
+void UProjectileManagerComponent::UpdateRendering()
+{
+	if (RenderGroupComps.Num() == 0) return;
+
+	for (auto& Transforms : RenderGroupTransforms) Transforms.Reset();
+
+	for (int32 i = 0; i < Locations.Num(); ++i)
+	{
+		if (RenderGroups[i] == INDEX_NONE) continue;
+
+		const int32 Group = RenderGroups[i];
+		RenderGroupTransforms[Group].Emplace(Velocities[i].Rotation(), Locations[i], RenderGroupScales[Group]);
+	}
+
+	for (int32 g = 0; g < RenderGroupComps.Num(); ++g)
+	{
+		auto Comp = RenderGroupComps[g];
+		if (!Comp) continue;
+
+		auto& Transforms = RenderGroupTransforms[g];
+
+		// Grow/shrink the instance count to match then move the lot in one go
+		while (Comp->GetInstanceCount() > Transforms.Num()) Comp->RemoveInstance(Comp->GetInstanceCount() - 1);
+		while (Comp->GetInstanceCount() < Transforms.Num()) Comp->AddInstanceWorldSpace(FTransform::Identity);
+
+		if (Transforms.Num() > 0)
+		{
+			Comp->BatchUpdateInstancesTransforms(0, Transforms, true, true, true);
+		}
+	}
+}
@@ -0,0 +1,123 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "Containers/ArrayView.h"
+#include "LagCompensationComponent.h"
+
+#include "ProjectileManagerComponent.generated.h"
+
+class AProjectile;
+class UStaticMesh;
+class UInstancedStaticMeshComponent;
+
+// Per projectile class settings, read once from the class defaults
+USTRUCT()
+struct FBatchedProjectileDesc
+{
+	GENERATED_BODY()
+
+	float Speed = 3000.f;
+	float Radius = 15.f;
+	float Damage = 1.f;
+	float LifeSpan = 5.f;
+
+	UPROPERTY()
+		UStaticMesh* Mesh = nullptr;
+
+	FVector MeshScale = FVector::OneVector;
+
+	static FBatchedProjectileDesc FromClass(TSubclassOf<AProjectile> ProjectileClass);
+};
+
+// Where a projectile/trace segment stopped and what it hit
+struct FSegmentHit
+{
+	FVector Location = FVector::ZeroVector;
+	AActor* Victim = nullptr;
+	UPrimitiveComponent* WorldComponent = nullptr;
+};
+
+/**
+ * Simulates straight line projectiles in bulk instead of as individual actors.
+ * Server copies are authoritative and apply damage. Client copies are cosmetic and only stop on impact.
+ */
+UCLASS(ClassGroup = (Custom))
+class MEATREALM_API UProjectileManagerComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	// Impulse applied to physics bodies we hit, scaled by projectile velocity
+	UPROPERTY(EditAnywhere)
+		float ImpulseFactor = 10.f;
+
+	// Impulse applied to physics bodies hit by hitscan traces
+	UPROPERTY(EditAnywhere)
+		float HitscanImpulse = 30000.f;
+
+	// Rewind times are rounded to this (seconds) at spawn, so a tick only builds a handful of capsule snapshots
+	// however much everyone's ping varies. About one server tick.
+	UPROPERTY(EditAnywhere)
+		float RewindStep = 1.f / 30.f;
+
+private:
+	/// Live projectiles - structure of arrays, all indexed together
+	TArray<FVector> Locations;
+	TArray<FVector> Velocities;
+	TArray<float> Radii;
+	TArray<uint32> OwnerIds;
+	TArray<float> Damages;
+	TArray<float> SpawnTimes;
+	TArray<float> LifeSpans;
+	TArray<TWeakObjectPtr<AActor>> Instigators;
+	TArray<int32> RewindSteps;
+	TArray<int32> RenderGroups;
+
+	/// Scratch reused every pass. One hero capsule snapshot per distinct rewind step.
+	TArray<TArray<FRewoundCapsule>> Snapshots;
+	TMap<int32, int32> SnapshotIndexByStep;
+	TArray<FRewoundCapsule> HitscanCapsules;
+
+	/// Rendering
+	UPROPERTY()
+		TArray<UInstancedStaticMeshComponent*> RenderGroupComps;
+
+	TArray<TArray<FTransform>> RenderGroupTransforms;
+	TArray<FVector> RenderGroupScales;
+
+
+public:
+	UProjectileManagerComponent();
+	static UProjectileManagerComponent* Get(const UWorld* World);
+
+	// Age fast forwards the projectile, for shots that happened a little while ago on the server.
+	// RewindTime tests hits against heroes as they were that long ago (lag compensation).
+	void SpawnProjectile(const FBatchedProjectileDesc& Desc, const FVector& Origin, const FVector& Direction, uint32 OwnerId, AActor* Instigator, float Age = 0.f, float RewindTime = 0.f);
+
+	// Resolves a trigger pull's worth of instant traces in one pass. OutEnds gets where each trace stopped.
+	// Only applies damage when authoritative, otherwise it's just working out where to draw tracers.
+	void ResolveHitscan(const FVector& Origin, TArrayView<const FVector> Directions, float Range, float Damage, uint32 OwnerId,
+		AActor* Instigator, float RewindTime, bool bIsAuthoritative, TArray<FVector>& OutEnds);
+
+	int32 GetNumProjectiles() const { return Locations.Num(); }
+
+protected:
+	void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+	void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+private:
+	const TArray<FRewoundCapsule>& GetSnapshot(int32 Step, bool bIsAuthoritative);
+	void GatherCurrentCapsules(TArray<FRewoundCapsule>& Out) const;
+	void Simulate(float DeltaTime, bool bIsAuthoritative);
+	bool TraceSegment(const FVector& Start, const FVector& End, float Radius, const AActor* Instigator,
+		const TArray<FRewoundCapsule>& Capsules, FSegmentHit& OutHit) const;
+	void ApplyHit(const FSegmentHit& Hit, const FVector& Impulse, uint32 OwnerId, float Damage) const;
+	void RemoveProjectile(int32 Index);
+	void RemoveAll();
+
+	int32 FindOrAddRenderGroup(UStaticMesh* Mesh, const FVector& Scale);
+	void UpdateRendering();
+};
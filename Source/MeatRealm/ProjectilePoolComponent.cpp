@@ -0,0 +1,147 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ProjectilePoolComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/GameStateBase.h"
+#include "Kismet/GameplayStatics.h"
+#include "MeatRealm.h"
+#include "Projectile.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Projectile Pool Hits"), STAT_ProjectilePoolHits, STATGROUP_MeatRealm);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Projectile Pool Misses"), STAT_ProjectilePoolMisses, STATGROUP_MeatRealm);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Projectile Pool Size"), STAT_ProjectilePoolSize, STATGROUP_MeatRealm);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Projectiles Active"), STAT_ProjectilesActive, STATGROUP_MeatRealm);
+
+UProjectilePoolComponent::UProjectilePoolComponent()
+{
+	PrimaryComponentTick.bCanEverTick = false;
+}
+
+UProjectilePoolComponent* UProjectilePoolComponent::Get(const UWorld* World)
+{
+	if (!World) return nullptr;
+
+	const auto GameState = World->GetGameState();
+	return GameState ? GameState->FindComponentByClass<UProjectilePoolComponent>() : nullptr;
+}
+
+void UProjectilePoolComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	// The level owns the actors, we just forget about them
+	FreeLists.Empty();
+	NumPooled = 0;
+	NumActive = 0;
+	UpdateStats();
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void UProjectilePoolComponent::Prewarm(TSubclassOf<AProjectile> ProjectileClass, int32 Count)
+{
+	if (!ProjectileClass || !GetOwner() || !GetOwner()->HasAuthority()) return;
+
+	// Only warm a class the first time we see it
+	if (FreeLists.Contains(ProjectileClass)) return;
+
+	auto& FreeList = FreeLists.Add(ProjectileClass);
+	FreeList.Projectiles.Reserve(Count);
+
+	for (int i = 0; i < Count; ++i)
+	{
+		auto* Projectile = SpawnProjectile(ProjectileClass, FTransform::Identity, nullptr, nullptr);
+		if (!Projectile) break;
+
+		Projectile->DeactivateToPool();
+		FreeList.Projectiles.Add(Projectile);
+		++NumPooled;
+	}
+
+	UpdateStats();
+}
+
+AProjectile* UProjectilePoolComponent::Acquire(TSubclassOf<AProjectile> ProjectileClass, const FTransform& Tform, AActor* Owner, APawn* Instigator)
+{
+	check(GetOwner() && GetOwner()->HasAuthority());
+	if (!ProjectileClass) return nullptr;
+
+	AProjectile* Projectile = nullptr;
+
+	auto* FreeList = FreeLists.Find(ProjectileClass);
+	while (FreeList && FreeList->Projectiles.Num() > 0 && !Projectile)
+	{
+		Projectile = FreeList->Projectiles.Pop(false);
+		--NumPooled;
+
+		// Someone else destroyed it (level streaming, world cleanup). Drop it and try the next.
+		if (Projectile && Projectile->IsPendingKill()) Projectile = nullptr;
+	}
+
+	if (Projectile)
+	{
+		++NumHits;
+		Projectile->SetOwner(Owner);
+		Projectile->Instigator = Instigator;
+		Projectile->ActivateFromPool(Tform);
+	}
+	else
+	{
+		++NumMisses;
+		Projectile = SpawnProjectile(ProjectileClass, Tform, Owner, Instigator);
+		if (!Projectile) return nullptr;
+	}
+
+	++NumActive;
+	UpdateStats();
+
+	return Projectile;
+}
+
+void UProjectilePoolComponent::Release(AProjectile* Projectile)
+{
+	if (!Projectile || Projectile->IsPendingKill()) return;
+
+	--NumActive;
+
+	auto& FreeList = FreeLists.FindOrAdd(Projectile->GetClass());
+	if (FreeList.Projectiles.Num() >= MaxPooledPerClass)
+	{
+		Projectile->Destroy();
+		UpdateStats();
+		return;
+	}
+
+	Projectile->DeactivateToPool();
+	FreeList.Projectiles.Add(Projectile);
+	++NumPooled;
+
+	UpdateStats();
+}
+
+AProjectile* UProjectilePoolComponent::SpawnProjectile(TSubclassOf<AProjectile> ProjectileClass, const FTransform& Tform, AActor* Owner, APawn* Instigator)
+{
+	UWorld* World = GetWorld();
+	if (!World) return nullptr;
+
+	AProjectile* Projectile = World->SpawnActorDeferred<AProjectile>(
+		ProjectileClass,
+		Tform,
+		Owner,
+		Instigator,
+		ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
+	if (!Projectile) return nullptr;
+
+	Projectile->SetPool(this);
+
+	UGameplayStatics::FinishSpawningActor(Projectile, Tform);
+
+	return Projectile;
+}
+
+void UProjectilePoolComponent::UpdateStats() const
+{
+	SET_DWORD_STAT(STAT_ProjectilePoolHits, NumHits);
+	SET_DWORD_STAT(STAT_ProjectilePoolMisses, NumMisses);
+	SET_DWORD_STAT(STAT_ProjectilePoolSize, NumPooled);
+	SET_DWORD_STAT(STAT_ProjectilesActive, NumActive);
+}
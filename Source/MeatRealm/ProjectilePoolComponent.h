@@ -0,0 +1,66 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+
+#include "ProjectilePoolComponent.generated.h"
+
+class AProjectile;
+
+USTRUCT()
+struct FProjectileFreeList
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+		TArray<AProjectile*> Projectiles;
+};
+
+/**
+ * Per-world pool of projectile actors. Lives on the game state so every world has exactly one.
+ * Projectiles are spawned once, then recycled on hit/expiry instead of being destroyed. [Server]
+ */
+UCLASS(ClassGroup = (Custom))
+class MEATREALM_API UProjectilePoolComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	// Number of projectiles created the first time a projectile class is requested
+	UPROPERTY(EditAnywhere)
+		int32 PrewarmCount = 32;
+
+	// Idle projectiles kept per class. Projectiles returned beyond this are destroyed.
+	UPROPERTY(EditAnywhere)
+		int32 MaxPooledPerClass = 256;
+
+private:
+	UPROPERTY()
+		TMap<UClass*, FProjectileFreeList> FreeLists;
+
+	int32 NumHits = 0;
+	int32 NumMisses = 0;
+	int32 NumPooled = 0;
+	int32 NumActive = 0;
+
+
+public:
+	UProjectilePoolComponent();
+	static UProjectilePoolComponent* Get(const UWorld* World);
+
+	void Prewarm(TSubclassOf<AProjectile> ProjectileClass, int32 Count);
+	AProjectile* Acquire(TSubclassOf<AProjectile> ProjectileClass, const FTransform& Tform, AActor* Owner, APawn* Instigator);
+	void Release(AProjectile* Projectile);
+
+	int32 GetHits() const { return NumHits; }
+	int32 GetMisses() const { return NumMisses; }
+	int32 GetPooledCount() const { return NumPooled; }
+	int32 GetActiveCount() const { return NumActive; }
+
+private:
+	void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+	AProjectile* SpawnProjectile(TSubclassOf<AProjectile> ProjectileClass, const FTransform& Tform, AActor* Owner, APawn* Instigator);
+	void UpdateStats() const;
+};
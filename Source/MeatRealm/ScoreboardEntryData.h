@@ -7,6 +7,8 @@
 
 #include "ScoreboardEntryData.generated.h"
 
+class AHeroState;
+
 UCLASS(BlueprintType)
 class MEATREALM_API UScoreboardEntryData : public UObject
 {
@@ -21,4 +23,6 @@ public:
 		int Deaths;
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
 		int Ping;
+
+	TWeakObjectPtr<AHeroState> Hero;
 };
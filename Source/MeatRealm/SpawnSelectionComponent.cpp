@@ -0,0 +1,231 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SpawnSelectionComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/GameStateBase.h"
+#include "GameFramework/PlayerStart.h"
+#include "EngineUtils.h"
+#include "MeatRealm.h"
+#include "HeroCharacter.h"
+
+DECLARE_CYCLE_STAT(TEXT("Spawn Threat Update"), STAT_SpawnThreatUpdate, STATGROUP_MeatRealm);
+DECLARE_CYCLE_STAT(TEXT("Spawn Choose"), STAT_SpawnChoose, STATGROUP_MeatRealm);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Spawn Line Of Sight Traces"), STAT_SpawnTraces, STATGROUP_MeatRealm);
+
+USpawnSelectionComponent::USpawnSelectionComponent()
+{
+	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.bStartWithTickEnabled = false;
+
+	// Threat only needs to be roughly where everyone is
+	PrimaryComponentTick.TickInterval = 0.1f;
+}
+
+USpawnSelectionComponent* USpawnSelectionComponent::Get(const UWorld* World)
+{
+	if (!World) return nullptr;
+
+	const auto GameState = World->GetGameState();
+	return GameState ? GameState->FindComponentByClass<USpawnSelectionComponent>() : nullptr;
+}
+
+void USpawnSelectionComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (GetOwner()->HasAuthority()) CacheSpawnPoints();
+}
+
+void USpawnSelectionComponent::CacheSpawnPoints()
+{
+	SpawnPoints.Reset();
+
+	FIntPoint Min{ MAX_int32, MAX_int32 };
+	FIntPoint Max{ MIN_int32, MIN_int32 };
+
+	for (TActorIterator<APlayerStart> It(GetWorld()); It; ++It)
+	{
+		const FVector Location = It->GetActorLocation();
+		const FIntPoint Cell{ FMath::FloorToInt(Location.X / CellSize), FMath::FloorToInt(Location.Y / CellSize) };
+
+		Min = FIntPoint{ FMath::Min(Min.X, Cell.X), FMath::Min(Min.Y, Cell.Y) };
+		Max = FIntPoint{ FMath::Max(Max.X, Cell.X), FMath::Max(Max.Y, Cell.Y) };
+
+		SpawnPoints.Add(FSpawnPoint{ *It, Location, INDEX_NONE });
+	}
+
+	const int32 R = FMath::Max(ThreatRadiusCells, 0);
+
+	Kernel.Reset();
+	for (int32 Y = -R; Y <= R; ++Y)
+	{
+		for (int32 X = -R; X <= R; ++X)
+		{
+			Kernel.Add(FMath::Max(0.f, 1.f - FMath::Sqrt(float(X * X + Y * Y)) / (R + 1)));
+		}
+	}
+
+	if (SpawnPoints.Num() == 0)
+	{
+		GridSize = FIntPoint::ZeroValue;
+		Threat.Reset();
+		return;
+	}
+
+	GridOrigin = Min - FIntPoint{ R, R };
+	GridSize = Max - Min + FIntPoint{ 2 * R + 1, 2 * R + 1 };
+	Threat.Init(0.f, GridSize.X * GridSize.Y);
+
+	for (auto& Point : SpawnPoints)
+	{
+		Point.CellIndex = ToCellIndex(Point.Location);
+	}
+
+	// Anyone already in the world is stamped again from scratch
+	for (auto& Tracked : Heroes)
+	{
+		Tracked.CellIndex = INDEX_NONE;
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("SpawnSelection: %d player starts, %dx%d threat cells"), SpawnPoints.Num(), GridSize.X, GridSize.Y);
+}
+
+int32 USpawnSelectionComponent::ToCellIndex(const FVector& Location) const
+{
+	const int32 X = FMath::FloorToInt(Location.X / CellSize) - GridOrigin.X;
+	const int32 Y = FMath::FloorToInt(Location.Y / CellSize) - GridOrigin.Y;
+
+	if (X < 0 || Y < 0 || X >= GridSize.X || Y >= GridSize.Y) return INDEX_NONE;
+	return Y * GridSize.X + X;
+}
+
+void USpawnSelectionComponent::AddThreat(int32 CellIndex, float Scale)
+{
+	if (CellIndex == INDEX_NONE) return;
+
+	const int32 R = FMath::Max(ThreatRadiusCells, 0);
+	const int32 CX = CellIndex % GridSize.X;
+	const int32 CY = CellIndex / GridSize.X;
+	const int32 KernelWidth = 2 * R + 1;
+
+	for (int32 Y = FMath::Max(CY - R, 0); Y <= FMath::Min(CY + R, GridSize.Y - 1); ++Y)
+	{
+		for (int32 X = FMath::Max(CX - R, 0); X <= FMath::Min(CX + R, GridSize.X - 1); ++X)
+		{
+			Threat[Y * GridSize.X + X] += Scale * Kernel[(Y - CY + R) * KernelWidth + (X - CX + R)];
+		}
+	}
+}
+
+void USpawnSelectionComponent::RegisterHero(AHeroCharacter* Hero)
+{
+	check(GetOwner()->HasAuthority())
+	if (!Hero) return;
+
+	FTrackedHero Tracked;
+	Tracked.Hero = Hero;
+	Tracked.CellIndex = ToCellIndex(Hero->GetActorLocation());
+	AddThreat(Tracked.CellIndex, 1);
+
+	Heroes.Add(Tracked);
+	SetComponentTickEnabled(true);
+}
+
+void USpawnSelectionComponent::UnregisterHero(AHeroCharacter* Hero)
+{
+	const int32 Index = Heroes.IndexOfByPredicate([Hero](const FTrackedHero& Tracked) { return Tracked.Hero == Hero; });
+	if (Index == INDEX_NONE) return;
+
+	AddThreat(Heroes[Index].CellIndex, -1);
+	Heroes.RemoveAtSwap(Index);
+
+	if (Heroes.Num() == 0) SetComponentTickEnabled(false);
+}
+
+void USpawnSelectionComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+	SCOPE_CYCLE_COUNTER(STAT_SpawnThreatUpdate);
+
+	for (int32 i = Heroes.Num() - 1; i >= 0; --i)
+	{
+		auto& Tracked = Heroes[i];
+
+		const auto Hero = Tracked.Hero.Get();
+		if (!Hero)
+		{
+			AddThreat(Tracked.CellIndex, -1);
+			Heroes.RemoveAtSwap(i);
+			continue;
+		}
+
+		// Only moving between cells costs anything
+		const int32 CellIndex = ToCellIndex(Hero->GetActorLocation());
+		if (CellIndex == Tracked.CellIndex) continue;
+
+		AddThreat(Tracked.CellIndex, -1);
+		AddThreat(CellIndex, 1);
+		Tracked.CellIndex = CellIndex;
+	}
+
+	if (Heroes.Num() == 0) SetComponentTickEnabled(false);
+}
+
+APlayerStart* USpawnSelectionComponent::ChooseStart(const AController* Controller) const
+{
+	SCOPE_CYCLE_COUNTER(STAT_SpawnChoose);
+
+	// The least threatened few, best first. A little jitter so equally quiet starts take turns.
+	TArray<TPair<float, int32>, TInlineAllocator<8>> Best;
+	const int32 NumCandidates = FMath::Max(MaxLineOfSightChecks, 1);
+
+	for (int32 i = 0; i < SpawnPoints.Num(); ++i)
+	{
+		const auto& Point = SpawnPoints[i];
+		if (!Point.Start.IsValid()) continue;
+
+		const float Score = Threat[Point.CellIndex] + FMath::FRand() * 0.01f;
+		if (Best.Num() == NumCandidates && Score >= Best.Last().Key) continue;
+
+		int32 Insert = Best.Num();
+		while (Insert > 0 && Best[Insert - 1].Key > Score) --Insert;
+		Best.Insert(TPair<float, int32>{ Score, i }, Insert);
+
+		if (Best.Num() > NumCandidates) Best.Pop(false);
+	}
+
+	if (Best.Num() == 0) return nullptr;
+
+	for (const auto& Candidate : Best)
+	{
+		const auto& Point = SpawnPoints[Candidate.Value];
+		if (!IsSeen(Point.Location, Controller)) return Point.Start.Get();
+	}
+
+	// Seen everywhere, go with the quietest
+	return SpawnPoints[Best[0].Value].Start.Get();
+}
+
+bool USpawnSelectionComponent::IsSeen(const FVector& Location, const AController* Except) const
+{
+	const auto World = GetWorld();
+	const FVector Target = Location + FVector{ 0, 0, 50 }; // Roughly head height above the start's capsule centre
+	const float MaxDistSq = LineOfSightDistance * LineOfSightDistance;
+
+	for (const auto& Tracked : Heroes)
+	{
+		const auto Hero = Tracked.Hero.Get();
+		if (!Hero || Hero->GetController() == Except) continue;
+
+		const FVector Eye = Hero->GetPawnViewLocation();
+		if (FVector::DistSquared(Eye, Target) > MaxDistSq) continue;
+
+		FCollisionQueryParams Params{ TEXT("SpawnLineOfSight"), false, Hero };
+		INC_DWORD_STAT(STAT_SpawnTraces);
+
+		if (!World->LineTraceTestByChannel(Eye, Target, ECC_Visibility, Params)) return true;
+	}
+
+	return false;
+}
@@ -0,0 +1,86 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+
+#include "SpawnSelectionComponent.generated.h"
+
+class AController;
+class AHeroCharacter;
+class APlayerStart;
+
+/**
+ * Picks where to respawn. [Server]
+ * Player starts are cached when the map loads. Living heroes each add threat to a coarse grid around where they
+ * are, which is only touched when they cross into a new cell, so the threat at a start is a single read.
+ * The least threatened few are then checked for line of sight and the first nobody can see wins.
+ */
+UCLASS(ClassGroup = (Custom))
+class MEATREALM_API USpawnSelectionComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY(EditAnywhere)
+		float CellSize = 500.f; // cm
+
+	// How many cells a hero's threat reaches. Falls off to nothing at the edge.
+	UPROPERTY(EditAnywhere)
+		int32 ThreatRadiusCells = 4;
+
+	// How many of the least threatened starts get line of sight checks
+	UPROPERTY(EditAnywhere)
+		int32 MaxLineOfSightChecks = 4;
+
+	// Heroes further than this don't count as seeing a start
+	UPROPERTY(EditAnywhere)
+		float LineOfSightDistance = 4000.f; // cm
+
+private:
+	struct FSpawnPoint
+	{
+		TWeakObjectPtr<APlayerStart> Start;
+		FVector Location;
+		int32 CellIndex;
+	};
+
+	struct FTrackedHero
+	{
+		TWeakObjectPtr<AHeroCharacter> Hero;
+		int32 CellIndex = INDEX_NONE;
+	};
+
+	TArray<FSpawnPoint> SpawnPoints;
+	TArray<FTrackedHero> Heroes;
+
+	// Dense grid covering the starts plus the threat radius. Heroes outside it can't reach any start anyway.
+	TArray<float> Threat;
+	FIntPoint GridOrigin = FIntPoint::ZeroValue;
+	FIntPoint GridSize = FIntPoint::ZeroValue;
+
+	// What one hero adds around its cell, (2 * ThreatRadiusCells + 1) squared
+	TArray<float> Kernel;
+
+
+public:
+	USpawnSelectionComponent();
+	static USpawnSelectionComponent* Get(const UWorld* World);
+
+	void RegisterHero(AHeroCharacter* Hero);
+	void UnregisterHero(AHeroCharacter* Hero);
+
+	// The start Controller is safest at. Null if the map has none.
+	APlayerStart* ChooseStart(const AController* Controller) const;
+
+protected:
+	void BeginPlay() override;
+	void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+private:
+	void CacheSpawnPoints();
+	int32 ToCellIndex(const FVector& Location) const;
+	void AddThreat(int32 CellIndex, float Scale);
+	bool IsSeen(const FVector& Location, const AController* Except) const;
+};
@@ -0,0 +1,36 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "DmgHitResult.h"
+#include "Engine/NetSerialization.h"
+
+// Never negative so pack them
+static void SerializeCount(FArchive& Ar, int& Count)
+{
+	uint32 Packed = FMath::Max(Count, 0);
+	Ar.SerializeIntPacked(Packed);
+	Count = Packed;
+}
+
+bool FMRHitResult::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+{
+	Ar.SerializeIntPacked(ReceiverControllerId);
+	Ar.SerializeIntPacked(AttackerControllerId);
+
+	// Goes below zero on the killing blow
+	int16 Health = FMath::Clamp(HealthRemaining, int(MIN_int16), int(MAX_int16));
+	Ar << Health;
+	HealthRemaining = Health;
+
+	SerializeCount(Ar, DamageTaken);
+	SerializeCount(Ar, HitCount);
+
+	uint8 ArmourBit = bHitArmour ? 1 : 0;
+	Ar.SerializeBits(&ArmourBit, 1);
+	bHitArmour = ArmourBit != 0;
+
+	// Same precision as FVector_NetQuantize and FVector_NetQuantizeNormal
+	bOutSuccess = SerializePackedVector<1, 20>(HitLocation, Ar);
+	bOutSuccess &= SerializeFixedVector<1, 16>(HitDirection, Ar);
+	return true;
+}
@@ -24,5 +24,21 @@ struct MEATREALM_API FMRHitResult
 		FVector HitLocation;
 	UPROPERTY(BlueprintReadOnly)
 		FVector HitDirection;
+
+	// How many hits from the attacker were rolled into this one this frame
+	UPROPERTY(BlueprintReadOnly)
+		int HitCount = 1;
+
+	// Sent on every hit so keep it small: packed ids and counts, quantized vectors
+	bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess);
+};
+
+template<>
+struct TStructOpsTypeTraits<FMRHitResult> : public TStructOpsTypeTraitsBase2<FMRHitResult>
+{
+	enum
+	{
+		WithNetSerializer = true,
+	};
 };
 
@@ -0,0 +1,96 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "TimedActionComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/GameStateBase.h"
+#include "MeatRealm.h"
+#include "GameplayClock.h"
+
+DECLARE_CYCLE_STAT(TEXT("Timed Actions Tick"), STAT_TimedActionsTick, STATGROUP_MeatRealm);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Timed Actions Pending"), STAT_TimedActionsPending, STATGROUP_MeatRealm);
+
+UTimedActionComponent::UTimedActionComponent()
+{
+	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.bStartWithTickEnabled = false;
+}
+
+UTimedActionComponent* UTimedActionComponent::Get(const UWorld* World)
+{
+	if (!World) return nullptr;
+
+	const auto GameState = World->GetGameState();
+	return GameState ? GameState->FindComponentByClass<UTimedActionComponent>() : nullptr;
+}
+
+FTimedAction UTimedActionComponent::Start(float Duration, UObject* Owner, FTimedActionHandle& Handle, TFunction<void()> OnComplete)
+{
+	FTimedAction Action;
+	Action.StartTime = FGameplayClock::Now(GetWorld());
+	Action.Duration = Duration;
+
+	Schedule(Action, Owner, Handle, MoveTemp(OnComplete));
+	return Action;
+}
+
+void UTimedActionComponent::Schedule(const FTimedAction& Action, UObject* Owner, FTimedActionHandle& Handle, TFunction<void()> OnComplete)
+{
+	Cancel(Handle);
+
+	Handle.Id = NextId++;
+	if (NextId == 0) NextId = 1; // 0 is the invalid handle
+
+	EndTimes.Add(Action.StartTime + Action.Duration);
+	Ids.Add(Handle.Id);
+	Owners.Add(Owner);
+	Callbacks.Add(MoveTemp(OnComplete));
+
+	INC_DWORD_STAT(STAT_TimedActionsPending);
+	SetComponentTickEnabled(true);
+}
+
+void UTimedActionComponent::Cancel(FTimedActionHandle& Handle)
+{
+	if (!Handle.IsValid()) return;
+
+	const int32 Index = Ids.Find(Handle.Id);
+	if (Index != INDEX_NONE) RemoveAt(Index);
+
+	Handle.Id = 0;
+}
+
+void UTimedActionComponent::RemoveAt(int32 Index)
+{
+	EndTimes.RemoveAtSwap(Index, 1, false);
+	Ids.RemoveAtSwap(Index, 1, false);
+	Owners.RemoveAtSwap(Index, 1, false);
+	Callbacks.RemoveAtSwap(Index, 1, false);
+
+	DEC_DWORD_STAT(STAT_TimedActionsPending);
+}
+
+void UTimedActionComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+	SCOPE_CYCLE_COUNTER(STAT_TimedActionsTick);
+
+	const float Now = FGameplayClock::Now(GetWorld());
+
+	// Pull out everything that's due first. Callbacks are free to start or cancel other actions.
+	TArray<TFunction<void()>, TInlineAllocator<8>> Due;
+	for (int32 i = EndTimes.Num() - 1; i >= 0; --i)
+	{
+		if (EndTimes[i] > Now) continue;
+
+		if (Owners[i].IsValid()) Due.Add(MoveTemp(Callbacks[i]));
+		RemoveAt(i);
+	}
+
+	for (auto& Callback : Due)
+	{
+		Callback();
+	}
+
+	if (EndTimes.Num() == 0) SetComponentTickEnabled(false);
+}
@@ -0,0 +1,77 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+
+#include "TimedActionComponent.generated.h"
+
+// Something that takes a while. When it started and how long it takes is all anyone needs to follow along.
+USTRUCT(BlueprintType)
+struct FTimedAction
+{
+	GENERATED_BODY()
+
+	// Server world time it started, see FGameplayClock::Now(). Negative when not running.
+	UPROPERTY()
+		float StartTime = -1;
+
+	UPROPERTY()
+		float Duration = 0;
+
+	bool IsRunning() const { return StartTime >= 0; }
+	bool IsActiveAt(float Now) const { return IsRunning() && Now < StartTime + Duration; }
+	float GetRemaining(float Now) const { return IsRunning() ? FMath::Max(StartTime + Duration - Now, 0.f) : 0.f; }
+	float GetProgress(float Now) const
+	{
+		if (!IsRunning()) return 0;
+		return Duration > 0 ? FMath::Clamp((Now - StartTime) / Duration, 0.f, 1.f) : 1;
+	}
+	void Clear() { StartTime = -1; }
+};
+
+// Refers to a scheduled completion so it can be cancelled
+struct FTimedActionHandle
+{
+	uint32 Id = 0;
+	bool IsValid() const { return Id != 0; }
+};
+
+/**
+ * Per-world scheduler for timed actions (reloads, item use, equipping...). Lives on the game state.
+ * Completions sit in one compact array checked in a single pass, and it only ticks while something is pending.
+ */
+UCLASS(ClassGroup = (Custom))
+class MEATREALM_API UTimedActionComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+private:
+	// Parallel arrays, swap removed. The per frame pass only reads EndTimes.
+	TArray<float> EndTimes;
+	TArray<uint32> Ids;
+	TArray<TWeakObjectPtr<UObject>> Owners;
+	TArray<TFunction<void()>> Callbacks;
+
+	uint32 NextId = 1;
+
+public:
+	UTimedActionComponent();
+	static UTimedActionComponent* Get(const UWorld* World);
+
+	// Starts an action now and calls OnComplete when it's done, unless Owner has gone. Replaces anything Handle had.
+	FTimedAction Start(float Duration, UObject* Owner, FTimedActionHandle& Handle, TFunction<void()> OnComplete);
+
+	// Same as Start but for an action that's already running, e.g. one started on the server
+	void Schedule(const FTimedAction& Action, UObject* Owner, FTimedActionHandle& Handle, TFunction<void()> OnComplete);
+
+	void Cancel(FTimedActionHandle& Handle);
+	bool IsPending(const FTimedActionHandle& Handle) const { return Handle.IsValid() && Ids.Contains(Handle.Id); }
+
+protected:
+	void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+private:
+	void RemoveAt(int32 Index);
+};
@@ -3,6 +3,7 @@
 
 #include "Weapon.h"
 #include "Engine/World.h"
+#include "GameFramework/GameStateBase.h"
 #include "Components/ArrowComponent.h"
 #include "Components/SkeletalMeshComponent.h"
 #include "Components/StaticMeshComponent.h"
@@ -12,13 +13,17 @@
 #include "Kismet/GameplayStatics.h"
 #include "TimerManager.h"
 #include "Projectile.h"
+#include "ProjectilePoolComponent.h"
+#include "LagCompensationComponent.h"
 #include "HeroCharacter.h"
+#include "GameplayClock.h"
 #include "Interfaces/AffectableInterface.h"
 
 
 AWeapon::AWeapon()
 {
-	PrimaryActorTick.bCanEverTick = true;
+	// Nothing to tick, the receiver does the work and only while it's busy
+	PrimaryActorTick.bCanEverTick = false;
 	SetReplicates(true);
 	
 	RootComp = CreateDefaultSubobject<USceneComponent>(TEXT("Root"));
@@ -47,12 +52,40 @@ AWeapon::AWeapon()
 	ReceiverComp->SetDelegate(this);
 	ReceiverComp->SetIsReplicated(true);
 }
+void AWeapon::PostInitializeComponents()
+{
+	Super::PostInitializeComponents();
+
+	// Everything after this reads config from the definition
+	ActiveDefinition = Definition;
+	if (!ActiveDefinition)
+	{
+		const auto Defaults = GetClass()->GetDefaultObject<AWeapon>();
+		ActiveDefinition = UWeaponDefinition::GetLegacyDefinition(GetClass(), *Defaults->ReceiverComp,
+			Defaults->DrawDuration, Defaults->AdsMovementScale, Defaults->WeaponName);
+	}
+	WeaponName = ActiveDefinition->WeaponName;
+
+	ReceiverComp->SetDefinition(ActiveDefinition);
+}
+void AWeapon::BeginPlay()
+{
+	Super::BeginPlay();
+
+	BatchedDesc = FBatchedProjectileDesc::FromClass(ProjectileClass);
+
+	// Get the first trigger pull's projectiles made before anyone is shooting
+	if (HasAuthority() && ProjectileClass && ShotSimulation == EShotSimulation::ProjectileActor)
+	{
+		auto Pool = UProjectilePoolComponent::Get(GetWorld());
+		if (Pool) Pool->Prewarm(ProjectileClass, Pool->PrewarmCount);
+	}
+}
 void AWeapon::ConfigWeapon(FWeaponConfig& Config) const
 {
 	check(HasAuthority());
 
-	if (Config.AmmoInClip > -1) ReceiverComp->ClipSizeGiven = Config.AmmoInClip;
-	if (Config.AmmoInPool > -1) ReceiverComp->AmmoPoolGiven = Config.AmmoInPool;
+	ReceiverComp->OverrideAmmoGiven(Config.AmmoInClip, Config.AmmoInPool);
 
 	//LogMsgWithRole(FString::Printf(TEXT("OverrideAmmoGiven - Clip:%d Pool:%d"), Config.AmmoInClip, Config.AmmoInPool));
 }
@@ -64,26 +97,18 @@ void AWeapon::Equip()
 {
 	if (!HasAuthority())
 	{
-		ServerRPC_Equip();
-		return; // TODO Remove return to enable client preditiction (currently broken)
+		SendInput(EWeaponInput::Draw);
+		return;
 	}
 	ReceiverComp->DrawWeapon();
 }
-void AWeapon::ServerRPC_Equip_Implementation()
-{
-	Equip();
-}
-bool AWeapon::ServerRPC_Equip_Validate()
-{
-	return true;
-}
 
 void AWeapon::Unequip()
 {
 	if (!HasAuthority())
 	{
-		ServerRPC_Unequip();
-		return; // TODO Remove return to enable client preditiction (currently broken)
+		SendInput(EWeaponInput::Holster);
+		return;
 	}
 	ReceiverComp->HolsterWeapon();
 }
@@ -95,104 +120,88 @@ void AWeapon::ExitInventory()
 {
 }
 
-void AWeapon::ServerRPC_Unequip_Implementation()
-{
-	Unequip();
-}
-bool AWeapon::ServerRPC_Unequip_Validate()
-{
-	return true;
-}
-
 void AWeapon::Input_PullTrigger()
 {
 	if (!HasAuthority())
 	{
-		ServerRPC_PullTrigger();
-		return; // TODO Remove return to enable client preditiction (currently broken)
+		SendInput(EWeaponInput::PullTrigger);
+		return;
 	}
 	ReceiverComp->PullTrigger();
 }
-void AWeapon::ServerRPC_PullTrigger_Implementation()
-{
-	Input_PullTrigger();
-}
-bool AWeapon::ServerRPC_PullTrigger_Validate()
-{
-	return true;
-}
 
 void AWeapon::Input_ReleaseTrigger()
 {
 	if (!HasAuthority())
 	{
-		ServerRPC_ReleaseTrigger();
-		return; // TODO Remove return to enable client preditiction (currently broken)
+		SendInput(EWeaponInput::ReleaseTrigger);
+		return;
 	}
 	ReceiverComp->ReleaseTrigger();
 }
-void AWeapon::ServerRPC_ReleaseTrigger_Implementation()
-{
-	Input_ReleaseTrigger();
-}
-bool AWeapon::ServerRPC_ReleaseTrigger_Validate()
-{
-	return true;
-}
 
 void AWeapon::Input_Reload()
 {
 	if (!HasAuthority())
 	{
-		ServerRPC_Reload();
-		return; // TODO Remove return to enable client preditiction (currently broken)
+		SendInput(EWeaponInput::Reload);
+		return;
 	}
 	ReceiverComp->Reload();
 }
-void AWeapon::ServerRPC_Reload_Implementation()
-{
-	Input_Reload();
-}
-bool AWeapon::ServerRPC_Reload_Validate()
-{
-	return true;
-}
 
 void AWeapon::Input_AdsPressed()
 {
 	if (!HasAuthority()) 
 	{
-		ServerRPC_AdsPressed();
-		return; // TODO Remove return to enable client preditiction (currently broken)
+		SendInput(EWeaponInput::AdsPressed);
+		return;
 	}
 	ReceiverComp->AdsPressed();
 }
-void AWeapon::ServerRPC_AdsPressed_Implementation()
-{
-	Input_AdsPressed();
-}
-bool AWeapon::ServerRPC_AdsPressed_Validate()
-{
-	return true;
-}
 
 void AWeapon::Input_AdsReleased()
 {
 	if (!HasAuthority())
 	{
-		ServerRPC_AdsReleased();
-		return; // TODO Remove return to enable client preditiction (currently broken)
+		SendInput(EWeaponInput::AdsReleased);
+		return;
 	}
 	ReceiverComp->AdsReleased();
 }
-void AWeapon::ServerRPC_AdsReleased_Implementation()
+
+void AWeapon::SendInput(EWeaponInput Input)
 {
-	Input_AdsReleased();
+	ReceiverComp->PredictInput(Input);
+	SendInputPacket();
+
+	// Keep repeating until the server acks everything, in case this packet is lost
+	auto& TimerMan = GetWorld()->GetTimerManager();
+	if (!TimerMan.IsTimerActive(InputResendTimerHandle))
+	{
+		TimerMan.SetTimer(InputResendTimerHandle, this, &AWeapon::SendInputPacket, InputResendInterval, true);
+	}
 }
-bool AWeapon::ServerRPC_AdsReleased_Validate()
+void AWeapon::SendInputPacket()
 {
-	return true;
+	FWeaponInputPacket Packet;
+	if (!ReceiverComp->BuildInputPacket(Packet))
+	{
+		GetWorld()->GetTimerManager().ClearTimer(InputResendTimerHandle);
+		return;
+	}
+
+	ServerRPC_SendInputs(Packet);
+}
+void AWeapon::ServerRPC_SendInputs_Implementation(const FWeaponInputPacket& Packet)
+{
+	ReceiverComp->ServerApplyInputPacket(Packet);
+}
+bool AWeapon::ServerRPC_SendInputs_Validate(const FWeaponInputPacket& Packet)
+{
+	return UWeaponReceiverComponent::IsValidInputPacket(Packet);
 }
+
 bool AWeapon::CanGiveAmmo()
 {
 	return ReceiverComp->CanGiveAmmo();
@@ -207,6 +216,14 @@ bool AWeapon::TryGiveAmmo()
 
 
 void AWeapon::MultiRPC_NotifyOnShotFired_Implementation()
+{
+	// The owning client already played it when it predicted the shot
+	if (IsLocallyPredicted()) return;
+
+	PlayShotFiredEffects();
+}
+
+void AWeapon::PlayShotFiredEffects()
 {
 	if (MuzzleLightComp) MuzzleLightComp->SetVisibility(true);
 
@@ -220,6 +237,52 @@ void AWeapon::MultiRPC_NotifyOnShotFired_Implementation()
 }
 
 
+void AWeapon::MultiRPC_NotifyOnShotEvent_Implementation(const FShotEvent& Shot)
+{
+	if (IsLocallyPredicted()) return;
+
+	PlayShotFiredEffects();
+
+	// The server already has the real projectiles
+	if (HasAuthority())
+	{
+		if (ShotSimulation == EShotSimulation::Hitscan)
+		{
+			for (const auto& End : HitscanEnds)
+			{
+				OnTracerFired.Broadcast(Shot.Muzzle, End);
+			}
+		}
+		return;
+	}
+
+	auto Manager = UProjectileManagerComponent::Get(GetWorld());
+	if (!Manager) return;
+
+	// Catch up on the time the event spent in flight so our bullets line up with the server's
+	const float Age = FMath::Clamp(FGameplayClock::Now(GetWorld()) - Shot.ServerTime, 0.f, MaxShotEventCatchUp);
+
+	FRandomStream Random{ Shot.Seed };
+	FShotPattern ShotPattern;
+	ReceiverComp->CalcShotPattern(Shot.GetHeadingAngle(), Shot.bIsAdsing, Random, ShotPattern);
+
+	if (ShotSimulation == EShotSimulation::Hitscan)
+	{
+		// Trace locally just to find where the tracers stop. The server has already done the damage.
+		Manager->ResolveHitscan(Shot.Muzzle, ShotPattern, HitscanRange, 0, HeroControllerId, GetOwner(), 0, false, HitscanEnds);
+		for (const auto& End : HitscanEnds)
+		{
+			OnTracerFired.Broadcast(Shot.Muzzle, End);
+		}
+		return;
+	}
+
+	for (const auto& Direction : ShotPattern)
+	{
+		Manager->SpawnProjectile(BatchedDesc, Shot.Muzzle, Direction, HeroControllerId, GetOwner(), Age);
+	}
+}
+
 void AWeapon::ClientRPC_NotifyOnAmmoWarning_Implementation()
 {
 	//LogMsgWithRole("AWeapon::ClientRPC_NotifyOnAmmoWarning_Implementation()");
@@ -228,8 +291,37 @@ void AWeapon::ClientRPC_NotifyOnAmmoWarning_Implementation()
 
 
 /* IReceiverComponentDelegate */
-void AWeapon::ShotFired()
+void AWeapon::ShotFired(const FShotEvent& Shot)
 {
+	// Predicted shot. Effects and tracers only, the server fires the real one.
+	if (!HasAuthority())
+	{
+		PlayShotFiredEffects();
+
+		if (ShotSimulation == EShotSimulation::Hitscan)
+		{
+			ResolveHitscanShot(Shot);
+			for (const auto& End : HitscanEnds)
+			{
+				OnTracerFired.Broadcast(Shot.Muzzle, End);
+			}
+		}
+		return;
+	}
+
+	if (ShotSimulation == EShotSimulation::Hitscan)
+	{
+		ResolveHitscanShot(Shot);
+		MultiRPC_NotifyOnShotEvent(Shot);
+		return;
+	}
+
+	if (ShotSimulation == EShotSimulation::Batched)
+	{
+		MultiRPC_NotifyOnShotEvent(Shot);
+		return;
+	}
+
 	MultiRPC_NotifyOnShotFired();
 }
 void AWeapon::AmmoInClipChanged(int AmmoInClip)
@@ -238,7 +330,7 @@ void AWeapon::AmmoInClipChanged(int AmmoInClip)
 
 	if (AmmoInClip == 0)
 	{
-		ClientRPC_NotifyOnAmmoWarning();
+		NotifyOnAmmoWarning();
 	}
 }
 void AWeapon::AmmoInPoolChanged(int AmmoInPool)
@@ -246,9 +338,24 @@ void AWeapon::AmmoInPoolChanged(int AmmoInPool)
 	//LogMsgWithRole(FString::Printf(TEXT("AWeapon::AmmoInPoolChanged(%d)"), AmmoInPool));
 	if (AmmoInPool == 0)
 	{
-		ClientRPC_NotifyOnAmmoWarning();
+		NotifyOnAmmoWarning();
 	}
 }
+void AWeapon::NotifyOnAmmoWarning()
+{
+	if (!HasAuthority())
+	{
+		if (OnAmmoWarning.IsBound()) OnAmmoWarning.Broadcast();
+		return;
+	}
+
+	// A predicting owner has already warned itself
+	const auto Pawn = Cast<APawn>(GetOwner());
+	const bool bIsRemoteOwner = Pawn && !Pawn->IsLocallyControlled();
+	if (bPredictOnClient && bIsRemoteOwner) return;
+
+	ClientRPC_NotifyOnAmmoWarning();
+}
 void AWeapon::InReloadingChanged(bool IsReloading)
 {
 	//FString Str{ IsReloading ? "True" : "False" };
@@ -270,8 +377,15 @@ void AWeapon::OnReloadProgressChanged(float ReloadProgress)
 {
 	//LogMsgWithRole(FString::Printf(TEXT("AWeapon::OnReloadProgressChanged(%f)"), ReloadProgress));
 }
-bool AWeapon::SpawnAProjectile(const FVector& Direction)
+bool AWeapon::SpawnAProjectile(const FVector& Direction, float Age)
 {
+	// Nothing to spawn, the whole pull is traced at once in ShotFired
+	if (ShotSimulation == EShotSimulation::Hitscan)
+	{
+		PendingHitscanDirections.Add(Direction);
+		return true;
+	}
+
 	if (ProjectileClass == nullptr)
 	{
 		UE_LOG(LogTemp, Error, TEXT("Set a Projectile Class in your Weapon Blueprint to shoot"));
@@ -281,6 +395,9 @@ bool AWeapon::SpawnAProjectile(const FVector& Direction)
 	UWorld* World = GetWorld();
 	if (World == nullptr) { return false; }
 
+	// Predicted shot. Projectile actors replicate from the server so there's nothing to do.
+	if (!HasAuthority() && ShotSimulation != EShotSimulation::Batched) { return true; }
+
 
 
 	//const auto ProjectileStartTform = MuzzleLocationComp->GetComponentTransform();
@@ -290,6 +407,69 @@ bool AWeapon::SpawnAProjectile(const FVector& Direction)
 	const auto ProjectileStartTform = Hero->GetAimTransform();
 
 
+	return ShotSimulation == EShotSimulation::Batched
+		? SpawnBatchedProjectile(ProjectileStartTform, Direction, Age)
+		: SpawnActorProjectile(ProjectileStartTform, Direction, Age);
+}
+bool AWeapon::SpawnBatchedProjectile(const FTransform& Tform, const FVector& Direction, float Age)
+{
+	auto Manager = UProjectileManagerComponent::Get(GetWorld());
+	if (!Manager) return SpawnActorProjectile(Tform, Direction, Age);
+
+	// Clients only spawn cosmetic copies of their predicted shots
+	if (!HasAuthority())
+	{
+		Manager->SpawnProjectile(BatchedDesc, Tform.GetLocation(), Direction, HeroControllerId, GetOwner(), Age);
+		return true;
+	}
+
+	Manager->SpawnProjectile(BatchedDesc, Tform.GetLocation(), Direction, HeroControllerId, GetOwner(), Age, GetRewindTime());
+	return true;
+}
+void AWeapon::ResolveHitscanShot(const FShotEvent& Shot)
+{
+	auto Manager = UProjectileManagerComponent::Get(GetWorld());
+	if (Manager)
+	{
+		Manager->ResolveHitscan(Shot.Muzzle, PendingHitscanDirections, HitscanRange, HitscanDamage, HeroControllerId,
+			GetOwner(), HasAuthority() ? GetRewindTime() : 0, HasAuthority(), HitscanEnds);
+	}
+
+	PendingHitscanDirections.Reset();
+}
+bool AWeapon::IsLocallyPredicted()
+{
+	if (!bPredictOnClient || HasAuthority()) return false;
+
+	const auto Pawn = Cast<APawn>(GetOwner());
+	return Pawn && Pawn->IsLocallyControlled();
+}
+float AWeapon::GetRewindTime() const
+{
+	// Resolve hits against where targets were on the shooter's screen
+	const auto LagComp = ULagCompensationComponent::Get(GetWorld());
+	const auto Hero = Cast<AHeroCharacter>(GetOwner());
+	return LagComp && Hero ? LagComp->GetRewindTime(Hero->GetPlayerState()) : 0.f;
+}
+bool AWeapon::SpawnActorProjectile(const FTransform& Tform, const FVector& Direction, float Age)
+{
+	UWorld* World = GetWorld();
+
+	// Start the projectile where it would be had it spawned exactly on time
+	FTransform ProjectileStartTform = Tform;
+	ProjectileStartTform.AddToTranslation(Direction * BatchedDesc.Speed * Age);
+
+	// Reuse a pooled projectile when we can
+	auto Pool = UProjectilePoolComponent::Get(World);
+	if (Pool)
+	{
+		AProjectile* Projectile = Pool->Acquire(ProjectileClass, ProjectileStartTform, GetOwner(), Instigator);
+		if (Projectile == nullptr) { return false; }
+
+		Projectile->SetHeroControllerId(HeroControllerId);
+		Projectile->FireInDirection(Direction);
+		return true;
+	}
 
 
 	// Spawn the projectile at the muzzle.
@@ -348,7 +528,7 @@ AActor* AWeapon::GetOwningPawn()
 }
 FString AWeapon::GetWeaponName()
 {
-	return WeaponName;
+	return ActiveDefinition ? ActiveDefinition->WeaponName : WeaponName;
 }
 
 void AWeapon::CancelAnyReload()
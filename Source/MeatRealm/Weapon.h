@@ -6,6 +6,7 @@
 #include "GameFramework/Actor.h"
 #include "WeaponReceiverComponent.h"
 #include "Interfaces/Equippable.h"
+#include "ProjectileManagerComponent.h"
 
 #include "Weapon.generated.h"
 
@@ -22,6 +23,18 @@ DECLARE_DYNAMIC_MULTICAST_DELEGATE(FReloadStarted);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE(FReloadEnded);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE(FShotFired);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE(FAmmoWarning);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FTracerFired, FVector, Start, FVector, End);
+
+UENUM(BlueprintType)
+enum class EShotSimulation : uint8
+{
+	// Every projectile is its own replicated actor (pooled)
+	ProjectileActor,
+	// Projectiles are simulated in bulk by the world's projectile manager
+	Batched,
+	// No projectiles, each pellet is an instant trace
+	Hitscan
+};
 
 USTRUCT()
 struct FWeaponConfig
@@ -67,16 +80,44 @@ protected:
 	UPROPERTY(EditDefaultsOnly, Category = Weapon)
 		TSubclassOf<class AProjectile> ProjectileClass;
 
+	// How projectiles are simulated. Batched only uses the ProjectileClass defaults (speed, radius, damage, mesh), so
+	// weapons opt in once their projectile has no blueprint behaviour of its own.
+	UPROPERTY(EditDefaultsOnly, Category = Weapon)
+		EShotSimulation ShotSimulation = EShotSimulation::ProjectileActor;
+
+	// Max distance (cm) of a hitscan pellet
+	UPROPERTY(EditDefaultsOnly, Category = Weapon)
+		float HitscanRange = 5000;
+
+	// Damage per hitscan pellet
+	UPROPERTY(EditDefaultsOnly, Category = Weapon)
+		float HitscanDamage = 1;
+
+	// Run the receiver on the owning client ahead of the server so firing feels immediate
+	UPROPERTY(EditDefaultsOnly, Category = Weapon)
+		bool bPredictOnClient = true;
+
+	// How often (seconds) unacked inputs are sent again
+	UPROPERTY(EditDefaultsOnly, Category = Weapon)
+		float InputResendInterval = 0.05f;
+
 
 	//// Configure the gun
 
+	// Shared config for every copy of this weapon. Without one, a definition is built from the legacy settings below
+	// and the receiver's, once per class.
+	UPROPERTY(EditDefaultsOnly, Category = Weapon)
+		UWeaponDefinition* Definition = nullptr;
+
 	// Time (seconds) to holster the weapon
 	//UPROPERTY(EditAnywhere)
 	//	float HolsterDuration = 0.5;
 
+	// Legacy, see Definition
 	UPROPERTY(EditAnywhere)
 		float DrawDuration = 1;
 
+	// Legacy, see Definition
 	UPROPERTY(EditAnywhere)
 		float AdsMovementScale = 0.70;
 
@@ -87,6 +128,10 @@ protected:
 	UPROPERTY(BlueprintAssignable, Category = "Event Dispatchers")
 		FAmmoWarning OnAmmoWarning;
 
+	// Hitscan only. Called once per pellet with where the trace started and stopped.
+	UPROPERTY(BlueprintAssignable, Category = "Event Dispatchers")
+		FTracerFired OnTracerFired;
+
 	UPROPERTY(BlueprintAssignable, Category = "Event Dispatchers")
 		FReloadStarted OnReloadStarted;
 
@@ -94,6 +139,7 @@ protected:
 		FReloadEnded OnReloadEnded;
 
 protected:
+	// Legacy, see Definition. Kept in sync with it for blueprints.
 	UPROPERTY(EditAnywhere, BlueprintReadOnly)
 		FString WeaponName = "NoNameWeapon";
 
@@ -101,6 +147,20 @@ private:
 	
 	uint32 HeroControllerId;
 
+	// Definition, or the legacy one if that's not set
+	UPROPERTY()
+		UWeaponDefinition* ActiveDefinition = nullptr;
+
+	UPROPERTY()
+		FBatchedProjectileDesc BatchedDesc;
+
+	// Clients fast forward late shot events by at most this much (seconds)
+	float MaxShotEventCatchUp = 0.25f;
+
+	// Hitscan pellets collected during a shot, resolved together when the shot completes
+	FShotPattern PendingHitscanDirections;
+	TArray<FVector> HitscanEnds;
+
 
 
 public:
@@ -110,7 +170,7 @@ public:
 	/* IEquippable */
 	void Equip() override;
 	void Unequip() override;
-	float GetEquipDuration() override { return DrawDuration; }
+	float GetEquipDuration() override { return ActiveDefinition->DrawDuration; }
 	void SetHidden(bool bIsHidden) override { SetActorHiddenInGame(bIsHidden); }
 	void EnterInventory() override;
 	void ExitInventory() override;
@@ -129,20 +189,21 @@ public:
 	bool CanGiveAmmo();
 	bool TryGiveAmmo();
 	void SetHeroControllerId(uint32 HeroControllerUid) { this->HeroControllerId = HeroControllerUid; }
-	float GetAdsMovementScale() const { return AdsMovementScale; }
+	float GetAdsMovementScale() const { return ActiveDefinition->AdsMovementScale; }
 	//float GetHolsterDuration() const { return HolsterDuration; }
 
 	/* IReceiverComponentDelegate */
-	void ShotFired() override;
+	void ShotFired(const FShotEvent& Shot) override;
 	void AmmoInClipChanged(int AmmoInClip) override;
 	void AmmoInPoolChanged(int AmmoInPool) override;
 	void InReloadingChanged(bool IsReloading) override;
 	void OnReloadProgressChanged(float ReloadProgress) override;
-	bool SpawnAProjectile(const FVector& Direction) override;
+	bool SpawnAProjectile(const FVector& Direction, float Age) override;
 	FVector GetBarrelDirection() override;
 	FVector GetBarrelLocation() override;
 	const UArrowComponent* GetMuzzleComponent() const { return MuzzleLocationComp; }
 	float GetDrawDuration() override;
+	bool IsLocallyPredicted() override;
 
 	AActor* GetOwningPawn() override;
 	FString GetWeaponName() override;
@@ -158,34 +219,37 @@ public:
 
 
 protected:
-private:
+	void PostInitializeComponents() override;
+	void BeginPlay() override;
 
-	UFUNCTION(Server, Reliable, WithValidation)
-		void ServerRPC_Equip();
-	
-	UFUNCTION(Server, Reliable, WithValidation)
-		void ServerRPC_Unequip();
-
-	UFUNCTION(Server, Reliable, WithValidation)
-		void ServerRPC_PullTrigger();
-
-	UFUNCTION(Server, Reliable, WithValidation)
-		void ServerRPC_ReleaseTrigger();
-
-	UFUNCTION(Server, Reliable, WithValidation)
-		void ServerRPC_Reload();
+private:
+	bool SpawnActorProjectile(const FTransform& Tform, const FVector& Direction, float Age);
+	bool SpawnBatchedProjectile(const FTransform& Tform, const FVector& Direction, float Age);
+	void ResolveHitscanShot(const FShotEvent& Shot);
+	float GetRewindTime() const;
 
-	UFUNCTION(Server, Reliable, WithValidation)
-		void ServerRPC_AdsPressed();
+	// Number the input, predict it and get it to the server
+	void SendInput(EWeaponInput Input);
+	void SendInputPacket();
 
-	UFUNCTION(Server, Reliable, WithValidation)
-		void ServerRPC_AdsReleased();
+	// Every input goes through here. Unreliable so a lost packet can't hold up the ones after it.
+	UFUNCTION(Server, Unreliable, WithValidation)
+		void ServerRPC_SendInputs(const FWeaponInputPacket& Packet);
 
 	UFUNCTION(NetMulticast, Reliable)
 		void MultiRPC_NotifyOnShotFired();
 
+	// Batched shots: one small event per trigger pull, clients rebuild the pellets themselves
+	UFUNCTION(NetMulticast, Unreliable)
+		void MultiRPC_NotifyOnShotEvent(const FShotEvent& Shot);
+
+	void PlayShotFiredEffects();
+
 	UFUNCTION(Client, Reliable)
 		void ClientRPC_NotifyOnAmmoWarning();
+	void NotifyOnAmmoWarning();
+
+	FTimerHandle InputResendTimerHandle;
 
 
 	void LogMsgWithRole(FString message) const;
@@ -0,0 +1,80 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "WeaponDefinition.h"
+#include "WeaponReceiverComponent.h"
+#include "UObject/Package.h"
+
+UWeaponDefinition* UWeaponDefinition::GetLegacyDefinition(UClass* WeaponClass, const UWeaponReceiverComponent& Receiver,
+	float DrawDuration, float AdsMovementScale, const FString& WeaponName)
+{
+	// Weak so a definition goes away with the last weapon holding it. Recompiling a blueprint makes a new class, so a new entry.
+	static TMap<TWeakObjectPtr<UClass>, TWeakObjectPtr<UWeaponDefinition>> Cache;
+
+	const auto Found = Cache.Find(WeaponClass);
+	if (Found && Found->IsValid()) return Found->Get();
+
+	auto Def = NewObject<UWeaponDefinition>(GetTransientPackage());
+	Def->ShotsPerSecond = Receiver.ShotsPerSecond;
+	Def->ProjectilesPerShot = Receiver.ProjectilesPerShot;
+	Def->AdsSpread = Receiver.AdsSpread;
+	Def->HipfireSpread = Receiver.HipfireSpread;
+	Def->bFullAuto = Receiver.bFullAuto;
+	Def->bUseClip = Receiver.bUseClip;
+	Def->bEvenSpread = Receiver.bEvenSpread;
+	Def->bSpreadClumping = Receiver.bSpreadClumping;
+	Def->ClipSize = Receiver.ClipSize;
+	Def->ClipSizeGiven = Receiver.ClipSizeGiven;
+	Def->AmmoPoolSize = Receiver.AmmoPoolSize;
+	Def->AmmoPoolGiven = Receiver.AmmoPoolGiven;
+	Def->AmmoGivenPerPickup = Receiver.AmmoGivenPerPickup;
+	Def->CanReceiveAmmo = Receiver.CanReceiveAmmo;
+	Def->ReloadTime = Receiver.ReloadTime;
+	Def->AdsLineLength = Receiver.AdsLineLength;
+	Def->AdsLineColor = Receiver.AdsLineColor;
+	Def->EnemyAdsLineLength = Receiver.EnemyAdsLineLength;
+	Def->EnemyAdsLineColor = Receiver.EnemyAdsLineColor;
+	Def->DrawDuration = DrawDuration;
+	Def->AdsMovementScale = AdsMovementScale;
+	Def->WeaponName = WeaponName;
+	Def->RebuildDerived();
+
+	Cache.Add(WeaponClass, Def);
+	return Def;
+}
+
+void UWeaponDefinition::PostLoad()
+{
+	Super::PostLoad();
+	RebuildDerived();
+}
+
+#if WITH_EDITOR
+void UWeaponDefinition::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+	RebuildDerived();
+}
+#endif
+
+void UWeaponDefinition::RebuildDerived()
+{
+	BuildFanOffsets(HipfireSpread, HipfireFanOffsets);
+	BuildFanOffsets(AdsSpread, AdsFanOffsets);
+}
+
+void UWeaponDefinition::BuildFanOffsets(float SpreadInDegrees, TArray<FVector2D>& OutOffsets) const
+{
+	OutOffsets.Reset();
+	if (!bEvenSpread || bSpreadClumping || ProjectilesPerShot < 2) return;
+
+	const float SpreadInRadians = FMath::DegreesToRadians(SpreadInDegrees);
+	const float OffsetPerProjectile = SpreadInRadians / (ProjectilesPerShot - 1);
+
+	for (int i = 0; i < ProjectilesPerShot; ++i)
+	{
+		float Sin, Cos;
+		FMath::SinCos(&Sin, &Cos, -SpreadInRadians / 2 + i * OffsetPerProjectile);
+		OutOffsets.Add(FVector2D{ Cos, Sin });
+	}
+}
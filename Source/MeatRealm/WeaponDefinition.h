@@ -0,0 +1,122 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+
+#include "WeaponDefinition.generated.h"
+
+class UWeaponReceiverComponent;
+
+/**
+ * Everything that's the same for every copy of a weapon. Shared by pointer and never written at runtime.
+ * Edits in the editor show up on live weapons straight away.
+ */
+UCLASS(BlueprintType)
+class MEATREALM_API UWeaponDefinition : public UDataAsset
+{
+	GENERATED_BODY()
+
+public:
+	/// Firing. Read every shot so kept together.
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Firing)
+		float ShotsPerSecond = 1.0f;
+
+	// The number of projectiles fired per shot
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Firing)
+		int ProjectilesPerShot = 1;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Firing)
+		float AdsSpread = 1;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Firing)
+		float HipfireSpread = 20;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Firing)
+		bool bFullAuto = true;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Firing)
+		bool bUseClip = true;
+
+	// When ProjectilesPerShot > 1 this ensures all projectiles are spread evenly across the HipfireSpread angle.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Firing)
+		bool bEvenSpread = true;
+
+	// This makes even spreading feel more natural by randomly clumping the shots within the even spread.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Firing, meta = (EditCondition = "bEvenSpread"))
+		bool bSpreadClumping = true;
+
+
+	/// Ammo
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Ammo, meta = (EditCondition = "bUseClip"))
+		int ClipSize = 10;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Ammo, meta = (EditCondition = "bUseClip"))
+		int ClipSizeGiven = 0;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Ammo)
+		int AmmoPoolSize = 30;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Ammo)
+		int AmmoPoolGiven = 20;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Ammo)
+		int AmmoGivenPerPickup = 10;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Ammo)
+		bool CanReceiveAmmo = true;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Ammo, meta = (EditCondition = "bUseClip"))
+		float ReloadTime = 3;
+
+
+	/// Handling
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Handling)
+		float DrawDuration = 1;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Handling)
+		float AdsMovementScale = 0.70;
+
+
+	/// Presentation
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Presentation)
+		FString WeaponName = "NoNameWeapon";
+
+	UPROPERTY(EditAnywhere, Category = Presentation)
+		float AdsLineLength = 1500; // cm
+
+	UPROPERTY(EditAnywhere, Category = Presentation)
+		FColor AdsLineColor = FColor{ 255,0,0 };
+
+	UPROPERTY(EditAnywhere, Category = Presentation)
+		float EnemyAdsLineLength = 175; // cm
+
+	UPROPERTY(EditAnywhere, Category = Presentation)
+		FColor EnemyAdsLineColor = FColor{ 255,170,75 };
+
+
+	/// Derived. Rebuilt whenever the above changes.
+
+	// Even spread fan offsets as (cos, sin). Only filled when the fan is fixed (no clumping).
+	TArray<FVector2D> HipfireFanOffsets;
+	TArray<FVector2D> AdsFanOffsets;
+
+
+	// Shared definition built from a weapon class that predates definition assets. One per class.
+	static UWeaponDefinition* GetLegacyDefinition(UClass* WeaponClass, const UWeaponReceiverComponent& Receiver,
+		float DrawDuration, float AdsMovementScale, const FString& WeaponName);
+
+	void PostLoad() override;
+#if WITH_EDITOR
+	void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
+
+private:
+	void RebuildDerived();
+	void BuildFanOffsets(float SpreadInDegrees, TArray<FVector2D>& OutOffsets) const;
+};
@@ -4,16 +4,136 @@
 #include "UnrealNetwork.h"
 #include "GameFramework/GameState.h"
 #include "DrawDebugHelpers.h"
+#include "MeatRealm.h"
+#include "GameplayClock.h"
+
+// String logging is for development only
+#if UE_BUILD_SHIPPING || UE_BUILD_TEST
+#define RECEIVER_LOG(Message)
+#else
+#define RECEIVER_LOG(Message) LogMsgWithRole(Message)
+#endif
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Weapon Receivers Active"), STAT_ReceiversActive, STATGROUP_MeatRealm);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Weapon Receivers Dormant"), STAT_ReceiversDormant, STATGROUP_MeatRealm);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Weapon Prediction Corrections"), STAT_ReceiverCorrections, STATGROUP_MeatRealm);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Weapon Input Packets Received"), STAT_InputPacketsReceived, STATGROUP_MeatRealm);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Weapon Inputs Applied"), STAT_InputsApplied, STATGROUP_MeatRealm);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Weapon Inputs Repeated"), STAT_InputsRepeated, STATGROUP_MeatRealm);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Weapon Input Gaps"), STAT_InputGaps, STATGROUP_MeatRealm);
+
+bool FWeaponInputPacket::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+{
+	Ar << LastSeq;
+	Ar.SerializeBits(&HeldBits, 2);
+
+	uint8 Num = Inputs.Num();
+	Ar.SerializeBits(&Num, 4);
+
+	if (Ar.IsLoading())
+	{
+		if (Num > MaxInputs)
+		{
+			Ar.SetError();
+			bOutSuccess = false;
+			return false;
+		}
+		Inputs.SetNum(Num);
+	}
+
+	// 7 inputs, 3 bits each
+	for (auto& Input : Inputs)
+	{
+		uint8 Value = uint8(Input);
+		Ar.SerializeBits(&Value, 3);
+		Input = EWeaponInput(Value);
+	}
+
+	bOutSuccess = true;
+	return true;
+}
+
+// 5 modes, 3 bits. ADS, 1 bit.
+static void SerializeModeAndAds(FArchive& Ar, EWeaponModes& Mode, bool& IsAdsing)
+{
+	uint8 ModeBits = uint8(Mode);
+	Ar.SerializeBits(&ModeBits, 3);
+	Mode = EWeaponModes(ModeBits);
+
+	uint8 AdsBit = IsAdsing ? 1 : 0;
+	Ar.SerializeBits(&AdsBit, 1);
+	IsAdsing = AdsBit != 0;
+}
+
+// Counts are small and never negative so pack them
+static void SerializeCount(FArchive& Ar, int& Count)
+{
+	uint32 Packed = FMath::Max(Count, 0);
+	Ar.SerializeIntPacked(Packed);
+	Count = Packed;
+}
+
+bool FWeaponPublicState::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+{
+	SerializeModeAndAds(Ar, Mode, IsAdsing);
+
+	if (Mode == EWeaponModes::Reloading)
+	{
+		Ar << ReloadStartTime;
+	}
+
+	bOutSuccess = true;
+	return true;
+}
+
+bool FWeaponAck::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+{
+	Ar << InputSeq;
+	Ar << ShotCount;
+
+	SerializeModeAndAds(Ar, State.Mode, State.IsAdsing);
+	SerializeCount(Ar, State.AmmoInClip);
+	SerializeCount(Ar, State.AmmoInPool);
+	SerializeCount(Ar, State.BurstCount);
+
+	if (State.Mode == EWeaponModes::Reloading)
+	{
+		Ar << ReloadStartTime;
+	}
+
+	bOutSuccess = true;
+	return true;
+}
 
 void UWeaponReceiverComponent::GetLifetimeReplicatedProps(TArray< FLifetimeProperty >& OutLifetimeProps) const
 {
 	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
-	DOREPLIFETIME(UWeaponReceiverComponent, WeaponState);
+
+	// The owner predicts its own state and gets the server's view through Ack instead
+	DOREPLIFETIME_CONDITION(UWeaponReceiverComponent, PublicState, COND_SkipOwner);
+	DOREPLIFETIME_CONDITION(UWeaponReceiverComponent, Ack, COND_OwnerOnly);
+	DOREPLIFETIME_CONDITION(UWeaponReceiverComponent, SpreadSeed, COND_InitialOnly);
+}
+
+void UWeaponReceiverComponent::PreReplication(IRepChangedPropertyTracker& ChangedPropertyTracker)
+{
+	Super::PreReplication(ChangedPropertyTracker);
+
+	PublicState.Mode = WeaponState.Mode;
+	PublicState.IsAdsing = WeaponState.IsAdsing;
+	PublicState.ReloadStartTime = ReloadStartTime;
+
+	// Progress isn't sent, zero it so it doesn't mark the ack dirty every frame of a reload
+	Ack.State = WeaponState;
+	Ack.State.ReloadProgress = 0;
+	Ack.ReloadStartTime = ReloadStartTime;
+	Ack.ShotCount = ShotCount;
 }
 
 UWeaponReceiverComponent::UWeaponReceiverComponent()
 {
 	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.bStartWithTickEnabled = false;
 	bReplicates = true;
 }
 
@@ -23,11 +143,33 @@ void UWeaponReceiverComponent::BeginPlay()
 
 	if (HasAuthority())
 	{
-		WeaponState.AmmoInClip = ClipSizeGiven;
-		WeaponState.AmmoInPool = AmmoPoolGiven;
+		WeaponState.AmmoInClip = ClipGivenOverride > -1 ? ClipGivenOverride : Def->ClipSizeGiven;
+		WeaponState.AmmoInPool = PoolGivenOverride > -1 ? PoolGivenOverride : Def->AmmoPoolGiven;
+		SpreadSeed = FMath::Rand();
 
 		//LogMsgWithRole(FString::Printf(TEXT("BeginPlay - Clip:%d Pool:%d"), WeaponState.AmmoInClip, WeaponState.AmmoInPool));
 	}
+
+	INC_DWORD_STAT(STAT_ReceiversDormant);
+	UpdateTickEnabled();
+}
+void UWeaponReceiverComponent::OverrideAmmoGiven(int AmmoInClip, int AmmoInPool)
+{
+	ClipGivenOverride = AmmoInClip;
+	PoolGivenOverride = AmmoInPool;
+}
+void UWeaponReceiverComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (bIsTickActive)
+	{
+		DEC_DWORD_STAT(STAT_ReceiversActive);
+	}
+	else
+	{
+		DEC_DWORD_STAT(STAT_ReceiversDormant);
+	}
+
+	Super::EndPlay(EndPlayReason);
 }
 	
 
@@ -39,11 +181,13 @@ void UWeaponReceiverComponent::DrawWeapon()
 {
 	//LogMsgWithRole(FString::Printf(TEXT("InputState.DrawRequested = true")));
 	InputState.DrawRequested = true;
+	UpdateTickEnabled();
 }
 void UWeaponReceiverComponent::HolsterWeapon()
 {
 	//LogMsgWithRole(FString::Printf(TEXT("InputState.HolsterRequested = true")));
 	InputState.HolsterRequested = true;
+	UpdateTickEnabled();
 }
 void UWeaponReceiverComponent::PullTrigger()
 {
@@ -52,6 +196,7 @@ void UWeaponReceiverComponent::PullTrigger()
 	WeaponState.BurstCount = 0;
 	ShotTimes.Empty();
 
+	UpdateTickEnabled();
 }
 void UWeaponReceiverComponent::ReleaseTrigger()
 {
@@ -59,30 +204,251 @@ void UWeaponReceiverComponent::ReleaseTrigger()
 
 	WeaponState.BurstCount = 0;
 	ShotTimes.Empty();
+
+	UpdateTickEnabled();
 }
 void UWeaponReceiverComponent::Reload()
 {
 	InputState.ReloadRequested = true;
+	UpdateTickEnabled();
 }
 void UWeaponReceiverComponent::AdsPressed()
 {
 	InputState.AdsRequested = true;
 	WeaponState.IsAdsing = InputState.AdsRequested;
+	UpdateTickEnabled();
 }
 void UWeaponReceiverComponent::AdsReleased()
 {
 	InputState.AdsRequested = false;
 	WeaponState.IsAdsing = InputState.AdsRequested;
+	UpdateTickEnabled();
+}
+
+// Input sequencing and prediction
+
+void UWeaponReceiverComponent::PredictInput(EWeaponInput Input)
+{
+	PendingInputs.Add(FWeaponPendingInput{ ++LastInputSeq, Input });
+
+	if (IsPredicting())
+	{
+		ApplyInput(Input);
+	}
+	else
+	{
+		// ApplyInput normally keeps these
+		TrackHeldInput(Input);
+	}
+}
+bool UWeaponReceiverComponent::BuildInputPacket(FWeaponInputPacket& OutPacket) const
+{
+	if (PendingInputs.Num() == 0) return false;
+
+	OutPacket.LastSeq = LastInputSeq;
+	OutPacket.HeldBits = HeldInputs;
+	OutPacket.Inputs.Reset();
+
+	const int32 First = FMath::Max(PendingInputs.Num() - FWeaponInputPacket::MaxInputs, 0);
+	for (int32 i = First; i < PendingInputs.Num(); ++i)
+	{
+		OutPacket.Inputs.Add(PendingInputs[i].Input);
+	}
+
+	return true;
+}
+void UWeaponReceiverComponent::ServerApplyInputPacket(const FWeaponInputPacket& Packet)
+{
+	check(HasAuthority());
+	INC_DWORD_STAT(STAT_InputPacketsReceived);
+
+	// Sequence numbers wrap, so compare the difference
+	const bool bMissedInputs = int16(Packet.GetFirstSeq() - Ack.InputSeq) > 1;
+
+	uint16 Seq = Packet.GetFirstSeq();
+	for (const auto Input : Packet.Inputs)
+	{
+		if (int16(Seq - Ack.InputSeq) > 0)
+		{
+			ApplyInput(Input);
+			Ack.InputSeq = Seq;
+			INC_DWORD_STAT(STAT_InputsApplied);
+		}
+		else
+		{
+			INC_DWORD_STAT(STAT_InputsRepeated);
+		}
+		++Seq;
+	}
+
+	// Lost more than a packet's worth. The presses are gone but we can at least match what's held down.
+	if (bMissedInputs)
+	{
+		INC_DWORD_STAT(STAT_InputGaps);
+
+		const auto Changed = HeldInputs ^ Packet.HeldBits;
+		if (Changed & FWeaponInputPacket::HeldTrigger)
+		{
+			ApplyInput(Packet.HeldBits & FWeaponInputPacket::HeldTrigger ? EWeaponInput::PullTrigger : EWeaponInput::ReleaseTrigger);
+		}
+		if (Changed & FWeaponInputPacket::HeldAds)
+		{
+			ApplyInput(Packet.HeldBits & FWeaponInputPacket::HeldAds ? EWeaponInput::AdsPressed : EWeaponInput::AdsReleased);
+		}
+	}
+}
+bool UWeaponReceiverComponent::IsValidInputPacket(const FWeaponInputPacket& Packet)
+{
+	if (Packet.Inputs.Num() > FWeaponInputPacket::MaxInputs) return false;
+
+	for (const auto Input : Packet.Inputs)
+	{
+		if (uint8(Input) > uint8(EWeaponInput::AdsReleased)) return false;
+	}
+	return true;
+}
+void UWeaponReceiverComponent::ApplyInput(EWeaponInput Input)
+{
+	TrackHeldInput(Input);
+
+	switch (Input)
+	{
+	case EWeaponInput::Draw: DrawWeapon(); break;
+	case EWeaponInput::Holster: HolsterWeapon(); break;
+	case EWeaponInput::PullTrigger: PullTrigger(); break;
+	case EWeaponInput::ReleaseTrigger: ReleaseTrigger(); break;
+	case EWeaponInput::Reload: Reload(); break;
+	case EWeaponInput::AdsPressed: AdsPressed(); break;
+	case EWeaponInput::AdsReleased: AdsReleased(); break;
+	}
+}
+
+void UWeaponReceiverComponent::TrackHeldInput(EWeaponInput Input)
+{
+	switch (Input)
+	{
+	case EWeaponInput::PullTrigger: HeldInputs |= FWeaponInputPacket::HeldTrigger; break;
+	case EWeaponInput::ReleaseTrigger: HeldInputs &= ~FWeaponInputPacket::HeldTrigger; break;
+	case EWeaponInput::AdsPressed: HeldInputs |= FWeaponInputPacket::HeldAds; break;
+	case EWeaponInput::AdsReleased: HeldInputs &= ~FWeaponInputPacket::HeldAds; break;
+	default: break;
+	}
+}
+
+void UWeaponReceiverComponent::OnRep_Ack()
+{
+	// Forget inputs the server has now processed
+	PendingInputs.RemoveAll([&](const FWeaponPendingInput& Pending)
+	{
+		return int16(Pending.Seq - Ack.InputSeq) <= 0;
+	});
+
+	// Not predicting, the server's word is the state
+	if (!IsPredicting())
+	{
+		WeaponState = Ack.State;
+		ReloadStartTime = Ack.ReloadStartTime;
+		WeaponState.ReloadProgress = GetReloadProgress();
+		ShotCount = Ack.ShotCount;
+		UpdateTickEnabled();
+		return;
+	}
+
+	// Take the server's state outright the first time we hear from it
+	if (!bHasReceivedAck)
+	{
+		bHasReceivedAck = true;
+		SnapToServer();
+		return;
+	}
+
+	// Mode changes land up to a round trip apart on each side. Only correct if we still disagree after a grace period.
+	if (IsInAgreementWithServer())
+	{
+		GetWorld()->GetTimerManager().ClearTimer(CorrectionTimerHandle);
+	}
+	else if (!GetWorld()->GetTimerManager().IsTimerActive(CorrectionTimerHandle))
+	{
+		GetWorld()->GetTimerManager().SetTimer(CorrectionTimerHandle, this, &UWeaponReceiverComponent::CheckPrediction, CorrectionGrace, false);
+	}
+}
+bool UWeaponReceiverComponent::IsInAgreementWithServer() const
+{
+	// Still waiting on the server to see some of our inputs
+	if (PendingInputs.Num() > 0) return true;
+
+	// Shots we've fired that the server hasn't yet
+	const int32 UnackedShots = FMath::Max<int32>(int16(ShotCount - Ack.ShotCount), 0);
+
+	const int32 ExpectedClip = Ack.State.AmmoInClip - (Def->bUseClip ? UnackedShots : 0);
+	const int32 ExpectedPool = Ack.State.AmmoInPool - (Def->bUseClip ? 0 : UnackedShots);
+
+	return Ack.State.Mode == WeaponState.Mode
+		&& ExpectedClip == WeaponState.AmmoInClip
+		&& ExpectedPool == WeaponState.AmmoInPool;
+}
+void UWeaponReceiverComponent::CheckPrediction()
+{
+	if (!IsInAgreementWithServer())
+	{
+		SnapToServer();
+	}
 }
+void UWeaponReceiverComponent::SnapToServer()
+{
+	INC_DWORD_STAT(STAT_ReceiverCorrections);
+
+	//LogMsgWithRole(FString::Printf(TEXT("SnapToServer() - %s > %s"), *EWeaponModesStr(WeaponState.Mode), *EWeaponModesStr(Ack.State.Mode)));
+
+	GetWorld()->GetTimerManager().ClearTimer(CorrectionTimerHandle);
+	CancelBusy();
+	bIsBusy = false;
+	bIsMidReload = false;
+
+	// Keep our own ADS, it's purely driven by our input
+	const bool bWasAdsing = WeaponState.IsAdsing;
+	WeaponState = Ack.State;
+	WeaponState.IsAdsing = bWasAdsing;
+	ReloadStartTime = Ack.ReloadStartTime;
+	WeaponState.ReloadProgress = GetReloadProgress();
+
+	// Server fired more than we predicted? Take its count, otherwise keep our extra shots
+	if (int16(ShotCount - Ack.ShotCount) < 0) ShotCount = Ack.ShotCount;
+
+	const int32 UnackedShots = int16(ShotCount - Ack.ShotCount);
+	if (Def->bUseClip)
+		WeaponState.AmmoInClip = FMath::Max(WeaponState.AmmoInClip - UnackedShots, 0);
+	else
+		WeaponState.AmmoInPool = FMath::Max(WeaponState.AmmoInPool - UnackedShots, 0);
+
+	// Restart any timed state. Not perfect but it self corrects on the next ack.
+	if (WeaponState.Mode == EWeaponModes::Equipping)
+	{
+		StartBusy(Delegate->GetDrawDuration(), &UWeaponReceiverComponent::EquipEnd);
+	}
+	else if (WeaponState.Mode == EWeaponModes::Reloading)
+	{
+		ResumeReload();
+	}
+
+	// Replay what the server hasn't seen yet on top of its state
+	for (const auto& Pending : PendingInputs)
+	{
+		ApplyInput(Pending.Input);
+	}
+
+	UpdateTickEnabled();
+}
+
 bool UWeaponReceiverComponent::CanGiveAmmo()
 {
-	return CanReceiveAmmo && WeaponState.AmmoInPool < AmmoPoolSize;
+	return Def->CanReceiveAmmo && WeaponState.AmmoInPool < Def->AmmoPoolSize;
 }
 bool UWeaponReceiverComponent::TryGiveAmmo()
 {
-	if (WeaponState.AmmoInPool == AmmoPoolSize) return false;
+	if (WeaponState.AmmoInPool == Def->AmmoPoolSize) return false;
 
-	WeaponState.AmmoInPool = FMath::Min(WeaponState.AmmoInPool + AmmoGivenPerPickup, AmmoPoolSize);
+	WeaponState.AmmoInPool = FMath::Min(WeaponState.AmmoInPool + Def->AmmoGivenPerPickup, Def->AmmoPoolSize);
 
 	return true;
 }
@@ -92,7 +458,7 @@ void UWeaponReceiverComponent::CancelAnyReload()
 	if (WeaponState.Mode==EWeaponModes::Reloading)
 	{
 		bIsBusy = false;
-		GetWorld()->GetTimerManager().ClearTimer(BusyTimerHandle);
+		CancelBusy();
 		ChangeState(EWeaponCommands::ReloadEnd, WeaponState);
 	}
 }
@@ -107,7 +473,7 @@ void UWeaponReceiverComponent::TickComponent(float DeltaTime, ELevelTick TickTyp
 
 	
 	// TODO These ticks might only do 1 operation per tick. Maybe return a bool from each TickFunction if a state was changed so we can reprocess it right away?
-	if (HasAuthority())
+	if (IsSimulating())
 	{
 		switch (WeaponState.Mode)
 		{
@@ -146,7 +512,7 @@ void UWeaponReceiverComponent::TickComponent(float DeltaTime, ELevelTick TickTyp
 		}
 
 		default:
-			LogMsgWithRole(FString::Printf(TEXT("TickComponent() - WeaponMode unimplemented %s"), *EWeaponModesStr(WeaponState.Mode)));
+			RECEIVER_LOG(FString::Printf(TEXT("TickComponent() - WeaponMode unimplemented %s"), *EWeaponModesStr(WeaponState.Mode)));
 		}
 	}
 
@@ -157,10 +523,113 @@ void UWeaponReceiverComponent::TickComponent(float DeltaTime, ELevelTick TickTyp
 		&& (WeaponState.Mode == EWeaponModes::Idle || WeaponState.Mode == EWeaponModes::Firing))
 	{
 		const bool IsAutonomous = GetOwnerOwnerLocalRole() == ROLE_AutonomousProxy;
-		const auto Color = IsAutonomous ? AdsLineColor : EnemyAdsLineColor;
-		const auto Length = IsAutonomous ? AdsLineLength : EnemyAdsLineLength;
+		const auto Color = IsAutonomous ? Def->AdsLineColor : Def->EnemyAdsLineColor;
+		const auto Length = IsAutonomous ? Def->AdsLineLength : Def->EnemyAdsLineLength;
 		DrawAdsLine(Color, Length);
 	}
+
+	UpdateTickEnabled();
+}
+
+bool UWeaponReceiverComponent::NeedsTick() const
+{
+	// Clients tick to draw the ADS line
+	const bool bDrawsAdsLine = !HasAuthority() && WeaponState.IsAdsing 
+		&& (WeaponState.Mode == EWeaponModes::Idle || WeaponState.Mode == EWeaponModes::Firing);
+	if (bDrawsAdsLine) return true;
+
+	// Everyone else only ticks to run the state machine
+	if (!IsSimulating()) return false;
+
+	switch (WeaponState.Mode)
+	{
+	case EWeaponModes::UnEquipped: return InputState.DrawRequested;
+	case EWeaponModes::Equipping: return InputState.HolsterRequested; // EquipEnd is on a timer
+	case EWeaponModes::Idle: return InputState.FireRequested || InputState.ReloadRequested || InputState.HolsterRequested;
+	case EWeaponModes::Firing: return true;
+	case EWeaponModes::Reloading: return true;
+	default: return true;
+	}
+}
+
+void UWeaponReceiverComponent::UpdateTickEnabled()
+{
+	const bool bShouldTick = NeedsTick();
+	if (bShouldTick == bIsTickActive) return;
+
+	bIsTickActive = bShouldTick;
+	SetComponentTickEnabled(bShouldTick);
+
+	if (bShouldTick)
+	{
+		DEC_DWORD_STAT(STAT_ReceiversDormant);
+		INC_DWORD_STAT(STAT_ReceiversActive);
+	}
+	else
+	{
+		DEC_DWORD_STAT(STAT_ReceiversActive);
+		INC_DWORD_STAT(STAT_ReceiversDormant);
+	}
+}
+
+void UWeaponReceiverComponent::OnRep_PublicState()
+{
+	WeaponState.Mode = PublicState.Mode;
+	WeaponState.IsAdsing = PublicState.IsAdsing;
+	ReloadStartTime = PublicState.ReloadStartTime;
+	WeaponState.ReloadProgress = GetReloadProgress();
+
+	UpdateTickEnabled();
+}
+
+FWeaponState UWeaponReceiverComponent::GetState() const
+{
+	// Only the server and a predicting owner tick the progress, so work it out fresh
+	auto State = WeaponState;
+	State.ReloadProgress = GetReloadProgress();
+	return State;
+}
+float UWeaponReceiverComponent::GetReloadProgress() const
+{
+	if (WeaponState.Mode != EWeaponModes::Reloading) return WeaponState.ReloadProgress;
+
+	return FMath::Clamp((GetServerTime() - ReloadStartTime) / GetReloadTime(), 0.f, 1.f);
+}
+float UWeaponReceiverComponent::GetServerTime() const
+{
+	return FGameplayClock::Now(GetWorld());
+}
+void UWeaponReceiverComponent::ResumeReload()
+{
+	// Pick up the server's reload where it's at rather than starting another
+	FTimedAction Reload;
+	Reload.StartTime = ReloadStartTime;
+	Reload.Duration = GetReloadTime();
+
+	bIsMidReload = true;
+	bIsBusy = true;
+	ScheduleBusy(Reload, &UWeaponReceiverComponent::ReloadEnd);
+}
+FTimedAction UWeaponReceiverComponent::StartBusy(float Duration, void(UWeaponReceiverComponent::*OnDone)())
+{
+	FTimedAction Action;
+	Action.StartTime = GetServerTime();
+	Action.Duration = Duration;
+
+	ScheduleBusy(Action, OnDone);
+	return Action;
+}
+void UWeaponReceiverComponent::ScheduleBusy(const FTimedAction& Action, void(UWeaponReceiverComponent::*OnDone)())
+{
+	auto Actions = UTimedActionComponent::Get(GetWorld());
+	if (!ensure(Actions)) return;
+
+	Actions->Schedule(Action, this, BusyAction, [this, OnDone] { (this->*OnDone)(); });
+}
+void UWeaponReceiverComponent::CancelBusy()
+{
+	auto Actions = UTimedActionComponent::Get(GetWorld());
+	if (Actions) Actions->Cancel(BusyAction);
 }
 
 bool UWeaponReceiverComponent::TickIdle(float DT)
@@ -228,43 +697,62 @@ bool UWeaponReceiverComponent::TickFiring(float DT)
 	}
 
 
+	const float Now = FGameplayClock::LocalNow(GetWorld());
 
-	if (bIsBusy) return false;
-	const auto bReceiverCanCycle = bFullAuto || WeaponState.BurstCount == 0;
+	// A fresh burst starts now (unless the last shot's cooldown is still running), and any backlog from time
+	// spent not shooting is dropped. Mid-burst we keep the exact cadence.
+	if (NextShotTime < Now - DT || (WeaponState.BurstCount == 0 && NextShotTime < Now))
+	{
+		NextShotTime = Now;
+	}
 
 
-	// Process State Transitions
+	// Fire every shot that fell due during this tick. Fast guns on slow ticks will fire several.
+	while (NextShotTime <= Now)
 	{
-		if (!InputState.FireRequested)
-		{ 
-			return ChangeState(EWeaponCommands::FireEnd, WeaponState);
-		}
-		
-		if (bReceiverCanCycle && NeedsReload() && CanReload())
+		const auto bReceiverCanCycle = Def->bFullAuto || WeaponState.BurstCount == 0;
+
+
+		// Process State Transitions
 		{
-			// Reload instead
-			return ChangeState(EWeaponCommands::ReloadStart, WeaponState);
+			if (!InputState.FireRequested)
+			{ 
+				return ChangeState(EWeaponCommands::FireEnd, WeaponState);
+			}
+			
+			if (bReceiverCanCycle && NeedsReload() && CanReload())
+			{
+				// Reload instead
+				return ChangeState(EWeaponCommands::ReloadStart, WeaponState);
+			}
 		}
-	}
 
 
-	// If we can't shoot, leave
-	{
-		const auto bHasAmmoReady = bUseClip ? WeaponState.AmmoInClip > 0 : WeaponState.AmmoInPool > 0;
-		const auto bCanShoot = bHasAmmoReady && bReceiverCanCycle;
-		if (!bCanShoot)
+		// If we can't shoot, leave
 		{
-			return false;
+			const auto bHasAmmoReady = Def->bUseClip ? WeaponState.AmmoInClip > 0 : WeaponState.AmmoInPool > 0;
+			const auto bCanShoot = bHasAmmoReady && bReceiverCanCycle;
+			if (!bCanShoot)
+			{
+				return false;
+			}
 		}
-	}
 
 
-	//LogMsgWithRole("TickFiring: BANG!");
+		//LogMsgWithRole("TickFiring: BANG!");
 
+		FireShot(NextShotTime, Now - NextShotTime);
+		NextShotTime += 1.f / Def->ShotsPerSecond;
+		LastShotTickTime = Now;
+	}
 
+	return false;
+}
+void UWeaponReceiverComponent::FireShot(float ShotTime, float Age)
+{
 	// Subtract some ammo
 	{
-		if (bUseClip)
+		if (Def->bUseClip)
 			--WeaponState.AmmoInClip;
 		else
 			--WeaponState.AmmoInPool;
@@ -272,67 +760,40 @@ bool UWeaponReceiverComponent::TickFiring(float DT)
 
 
 	// Fire the shot(s)!
-	auto ShotRate = 1.f / ShotsPerSecond;
-
-
-	float ShotRateError = 0;
+	FShotEvent Shot{};
 	{
-
-		// Record time of shot and compute how much slack time till the next shot
-		float Now = GetWorld()->TimeSeconds;
-
-		if (bFullAuto && ShotTimes.Num() > 0)
-		{
-			float TimeSinceFirstShot = Now - ShotTimes[0];
-			float ExpectedTimeSinceFirstShot = ShotRate * WeaponState.BurstCount;
-			float TotalError = TimeSinceFirstShot - ExpectedTimeSinceFirstShot;
-
-			//UE_LOG(LogTemp, Warning, TEXT("TimeSinceFirstShot:%f, ExpectedTimeSinceFirstShot:%f, Err:%f"), TimeSinceFirstShot, ExpectedTimeSinceFirstShot, TotalError);
-
-			ShotRateError = TotalError;
-		}
-
 		// Store shot timing/count
-		ShotTimes.Add(Now);
+		ShotTimes.Add(ShotTime);
 		WeaponState.BurstCount++;
 
 		// Shoot the damn thing!
-		auto ShotPattern = CalcShotPattern();
-		for (auto Direction : ShotPattern)
+		Shot.Muzzle = Delegate->GetBarrelLocation();
+		Shot.SetHeadingAngle(Delegate->GetBarrelDirection().HeadingAngle());
+		Shot.Seed = HashCombine(SpreadSeed, ShotCount) & 0xFFFF;
+		++ShotCount;
+		Shot.bIsAdsing = WeaponState.IsAdsing;
+
+		Shot.ServerTime = GetServerTime() - Age;
+
+		FRandomStream Random{ Shot.Seed };
+		FShotPattern ShotPattern;
+		CalcShotPattern(Shot.GetHeadingAngle(), Shot.bIsAdsing, Random, ShotPattern);
+		for (const auto& Direction : ShotPattern)
 		{
-			Delegate->SpawnAProjectile(Direction);
+			Delegate->SpawnAProjectile(Direction, Age);
 		}
 	}
 
 
-	// Start the busy timer
-	{
-		bIsBusy = true;
-
-		float TimeTillNextShot = FMath::Max<float>(ShotRate - ShotRateError, SMALL_NUMBER);
-		TimeTillNextShot -= 1/60.f; // TODO Hack! Generally the shots are delayed by about 1 tick @ 60Hz from the requested time. 
-
-		GetWorld()->GetTimerManager().SetTimer(BusyTimerHandle, this, &UWeaponReceiverComponent::FireEnd, TimeTillNextShot, false);
-	}
-
-
 	// Notify changes
 	{
-		Delegate->ShotFired();
+		Delegate->ShotFired(Shot);
 
-		if (bUseClip)
+		if (Def->bUseClip)
 			Delegate->AmmoInClipChanged(WeaponState.AmmoInClip);
 		else
 			Delegate->AmmoInPoolChanged(WeaponState.AmmoInPool);
 	}
-
-	return false;
-}
-void UWeaponReceiverComponent::FireEnd()
-{
-	//LogMsgWithRole("FireEnd");
-	bIsBusy = false;
-	GetWorld()->GetTimerManager().ClearTimer(BusyTimerHandle);
 }
 
 bool UWeaponReceiverComponent::TickReloading(float DT)
@@ -344,15 +805,14 @@ bool UWeaponReceiverComponent::TickReloading(float DT)
 	if (InputState.HolsterRequested)
 	{
 		InputState.HolsterRequested = false;
-		GetWorld()->GetTimerManager().ClearTimer(BusyTimerHandle);
+		CancelBusy();
 		return ChangeState(EWeaponCommands::UnEquip, WeaponState);
 	}
 
 	// Update reload progress
 	if (bIsMidReload)
 	{
-		const auto ElapsedReloadTime = (FDateTime::Now() - ReloadStartTime).GetTotalSeconds();
-		WeaponState.ReloadProgress = ElapsedReloadTime / GetReloadTime();
+		WeaponState.ReloadProgress = GetReloadProgress();
 		//auto str = FString::Printf(TEXT("InProgress %f"), WeaponState.ReloadProgress);
 		//LogMsgWithRole(str);
 	}
@@ -368,16 +828,15 @@ bool UWeaponReceiverComponent::TickReloading(float DT)
 		return ChangeState(EWeaponCommands::ReloadEnd, WeaponState);
 	}
 
-	LogMsgWithRole("Starting Reload");
+	RECEIVER_LOG("Starting Reload");
 
 	// Start Reloading!
 	bIsMidReload = true;
 	WeaponState.ReloadProgress = 0;
-	ReloadStartTime = FDateTime::Now();
 	WeaponState.IsAdsing = false;
 
 	bIsBusy = true;
-	GetWorld()->GetTimerManager().SetTimer(BusyTimerHandle, this, &UWeaponReceiverComponent::ReloadEnd, GetReloadTime(), false);
+	ReloadStartTime = StartBusy(GetReloadTime(), &UWeaponReceiverComponent::ReloadEnd).StartTime;
 
 	return false;
 }
@@ -395,10 +854,10 @@ void UWeaponReceiverComponent::ReloadEnd()
 	WeaponState.ReloadProgress = 100;
 
 	bIsBusy = false;
-	GetWorld()->GetTimerManager().ClearTimer(BusyTimerHandle);
+	CancelBusy();
 
 	// Take ammo from pool
-	const int AmmoNeeded = ClipSize - WeaponState.AmmoInClip;
+	const int AmmoNeeded = Def->ClipSize - WeaponState.AmmoInClip;
 	const int AmmoReceived = (AmmoNeeded > WeaponState.AmmoInPool) ? WeaponState.AmmoInPool : AmmoNeeded;
 	WeaponState.AmmoInPool -= AmmoReceived;
 	WeaponState.AmmoInClip += AmmoReceived;
@@ -440,8 +899,7 @@ bool UWeaponReceiverComponent::ChangeState(EWeaponCommands Cmd, FWeaponState& We
 		WeapState.Mode = EWeaponModes::Idle;
 	}
 
-	LogMsgWithRole(FString::Printf(TEXT("WeapReceiver::ChangeState(%s > %s > %s)"),
-		*EWeaponModesStr(OldMode), *EWeaponCommandsStr(Cmd), *EWeaponModesStr(WeapState.Mode)));
+	FlightRecorder.Record(FGameplayClock::LocalNow(GetWorld()), OldMode, Cmd, WeapState.Mode, WeapState.AmmoInClip, WeapState.AmmoInPool);
 
 	const bool bWeChangedStates = OldMode != WeapState.Mode;
 	if (bWeChangedStates)
@@ -449,6 +907,9 @@ bool UWeaponReceiverComponent::ChangeState(EWeaponCommands Cmd, FWeaponState& We
 		DoTransitionAction(OldMode, WeapState.Mode, WeapState);
 	}
 
+	// Timers land here too (EquipEnd, ReloadEnd) so this is where we wake back up
+	UpdateTickEnabled();
+
 	//WeaponState = OutState;
 
 	return bWeChangedStates;
@@ -467,7 +928,7 @@ void UWeaponReceiverComponent::DoTransitionAction(const EWeaponModes OldMode, co
 
 		// Stop any actions - should never be true.. TODO Convert these to asserts to make sure we've good elsewhere
 		bIsBusy = false;
-		GetWorld()->GetTimerManager().ClearTimer(BusyTimerHandle);
+		CancelBusy();
 
 		// Remove all input
 		InputState.Reset();
@@ -480,7 +941,7 @@ void UWeaponReceiverComponent::DoTransitionAction(const EWeaponModes OldMode, co
 		ShotTimes.Empty();
 
 
-		GetWorld()->GetTimerManager().SetTimer(BusyTimerHandle, this, &UWeaponReceiverComponent::EquipEnd, Delegate->GetDrawDuration(), false);
+		StartBusy(Delegate->GetDrawDuration(), &UWeaponReceiverComponent::EquipEnd);
 	}
 
 
@@ -492,7 +953,7 @@ void UWeaponReceiverComponent::DoTransitionAction(const EWeaponModes OldMode, co
 		// NEW HERE
 
 		bIsBusy = false;
-		GetWorld()->GetTimerManager().ClearTimer(BusyTimerHandle);
+		CancelBusy();
 
 		InputState.Reset();
 
@@ -511,44 +972,27 @@ void UWeaponReceiverComponent::DoTransitionAction(const EWeaponModes OldMode, co
 		//LogMsgWithRole("OldMode == Firing");
 
 
-		// Track the fire rate error and report as error if it's above a tolerance
-
-		// Compute the time between shots if we've had a burst of at least 3
+#if !(UE_BUILD_SHIPPING || UE_BUILD_TEST)
+		// Every shot due by the last tick that fired should have gone out, however the rate lines up with the tick.
+		// Dropped shots (eg a hitch resetting the schedule) or extra ones show up here. Running dry ends a burst early, skip those.
 		const auto Num = ShotTimes.Num();
-		auto TotalDiff = 0.f;
-		int Count = 0;
-		const int Skip = 1;
+		const auto bHasAmmo = Def->bUseClip ? NewState.AmmoInClip > 0 : NewState.AmmoInPool > 0;
 
-		if (bFullAuto && Num > Skip+1)
+		if (Def->bFullAuto && bHasAmmo && Num > 1)
 		{
-			for (int i = Skip+1; i < Num; ++i)
-			{
-				const auto First = ShotTimes[i-1];
-				const auto Second = ShotTimes[i];
-				const auto Diff = Second - First;
-				TotalDiff += Diff;
-				++Count;
-			}
-
-			// Report
-			const float Avg = TotalDiff / Count;
-			const float Expected = 1.f / ShotsPerSecond;
-			const float AvgDiff = Avg - Expected;
-			const float DiffPercentage = (Avg / Expected - 1) * 100;
+			// Shots often land right on a tick, so allow float rounding either way (a hundredth of a shot)
+			const float Elapsed = LastShotTickTime - ShotTimes[0];
+			const float Intervals = Elapsed * Def->ShotsPerSecond;
+			const int MinDue = FMath::FloorToInt(Intervals - 0.01f) + 1;
+			const int MaxDue = FMath::FloorToInt(Intervals + 0.01f) + 1;
 
-			//LogMsgWithRole(FString::Printf(TEXT("Avg:%f, Expected:%f, AvgDiff:%f %.3f%%"), Avg, Expected, AvgDiff, DiffPercentage));
-
-			const float ErrorTolerance = 1.5;
-			if (FMath::Abs(DiffPercentage) > ErrorTolerance) // error tolerance
+			if (Num < MinDue || Num > MaxDue)
 			{
-				UE_LOG(LogTemp, Error, TEXT("Gun fire rate error is %.3f%%. Time before shot:"), DiffPercentage);
-				for (int j = 1; j < ShotTimes.Num(); ++j)
-				{
-					const auto Diff = ShotTimes[j] - ShotTimes[j - 1];
-					UE_LOG(LogTemp, Error, TEXT("   Shot%d: %f"), j+1, Diff);
-				}
+				UE_LOG(LogTemp, Error, TEXT("Gun fired %d shots over %.3fs, %d were due"), Num, Elapsed, MinDue);
+				DumpFlightRecorder();
 			}
 		}
+#endif
 
 		ShotTimes.Empty();
 		NewState.BurstCount = 0;
@@ -561,65 +1005,73 @@ void UWeaponReceiverComponent::DoTransitionAction(const EWeaponModes OldMode, co
 
 bool UWeaponReceiverComponent::CanReload() const
 {
-	return bUseClip &&
-		WeaponState.AmmoInClip < ClipSize &&
+	return Def->bUseClip &&
+		WeaponState.AmmoInClip < Def->ClipSize &&
 		WeaponState.AmmoInPool > 0;
 }
 bool UWeaponReceiverComponent::NeedsReload() const
 {
-	return bUseClip && WeaponState.AmmoInClip < 1;
+	return Def->bUseClip && WeaponState.AmmoInClip < 1;
+}
+
+static FVector HeadingToDirection(float HeadingAngle)
+{
+	float Sin, Cos;
+	FMath::SinCos(&Sin, &Cos, HeadingAngle);
+	return FVector{ Cos, Sin, 0 };
 }
 
-TArray<FVector> UWeaponReceiverComponent::CalcShotPattern() const
+void UWeaponReceiverComponent::CalcShotPattern(float BarrelAngle, bool bIsAdsing, FRandomStream& Random, FShotPattern& OutShots) const
 {
-	TArray<FVector> Shots;
+	OutShots.Reset();
 
-	const float BarrelAngle = Delegate->GetBarrelDirection().HeadingAngle();
-	const float SpreadInRadians = FMath::DegreesToRadians(WeaponState.IsAdsing ? GetAdsSpread() :
+	const float SpreadInRadians = FMath::DegreesToRadians(bIsAdsing ? GetAdsSpread() :
 		GetHipfireSpread());
 
-	if (bEvenSpread && ProjectilesPerShot > 1)
+	if (Def->bEvenSpread && Def->ProjectilesPerShot > 1)
 	{
+		// Fixed fan. Rotate the prebuilt offsets onto the barrel, no trig per projectile.
+		const auto& FanOffsets = bIsAdsing ? Def->AdsFanOffsets : Def->HipfireFanOffsets;
+		if (FanOffsets.Num() == Def->ProjectilesPerShot)
+		{
+			const FVector Barrel = HeadingToDirection(BarrelAngle);
+			for (const auto& Offset : FanOffsets)
+			{
+				OutShots.Emplace(
+					Barrel.X * Offset.X - Barrel.Y * Offset.Y,
+					Barrel.Y * Offset.X + Barrel.X * Offset.Y, 0.f);
+			}
+			return;
+		}
+
 		// Shoot projectiles in an even fan with optional shot clumping.
-		for (int i = 0; i < ProjectilesPerShot; ++i)
+		const float BaseAngle = BarrelAngle - (SpreadInRadians / 2);
+		const float OffsetPerProjectile = SpreadInRadians / (Def->ProjectilesPerShot - 1);
+
+		for (int i = 0; i < Def->ProjectilesPerShot; ++i)
 		{
 			// TODO factor spread clumping into the base angle and offset per projectile
 			// Currently the projectile will spawn out of range of the max spread.
 
-			const float BaseAngle = BarrelAngle - (SpreadInRadians / 2);
-			const float OffsetPerProjectile = SpreadInRadians / (ProjectilesPerShot - 1);
 			float OffsetHeadingAngle = BaseAngle + i * OffsetPerProjectile;
 
 			// Optionally clump shots together within the fan for natural variance
-			if (bSpreadClumping)
+			if (Def->bSpreadClumping)
 			{
-				OffsetHeadingAngle += FMath::RandRange(-OffsetPerProjectile / 2, OffsetPerProjectile / 2);
+				OffsetHeadingAngle += Random.FRandRange(-OffsetPerProjectile / 2, OffsetPerProjectile / 2);
 			}
 
-			const FVector ShootDirectionWithSpread = FVector{
-				FMath::Cos(OffsetHeadingAngle),
-				FMath::Sin(OffsetHeadingAngle), 0 };
-
-			Shots.Add(ShootDirectionWithSpread);
+			OutShots.Add(HeadingToDirection(OffsetHeadingAngle));
 		}
 	}
 	else
 	{
-		for (int i = 0; i < ProjectilesPerShot; ++i)
+		for (int i = 0; i < Def->ProjectilesPerShot; ++i)
 		{
-			const float OffsetAngle = FMath::RandRange(-SpreadInRadians / 2, SpreadInRadians / 2);
-			const float OffsetHeadingAngle = BarrelAngle + OffsetAngle;
-
-			const FVector ShootDirectionWithSpread = FVector{
-				FMath::Cos(OffsetHeadingAngle),
-				FMath::Sin(OffsetHeadingAngle), 0 };
-
-			Shots.Add(ShootDirectionWithSpread);
+			const float OffsetAngle = Random.FRandRange(-SpreadInRadians / 2, SpreadInRadians / 2);
+			OutShots.Add(HeadingToDirection(BarrelAngle + OffsetAngle));
 		}
 	}
-
-
-	return Shots;
 }
 
 void UWeaponReceiverComponent::DrawAdsLine(const FColor& Color, float LineLength) const
@@ -645,6 +1097,26 @@ void UWeaponReceiverComponent::DrawAdsLine(const FColor& Color, float LineLength
 	DrawDebugLine(GetWorld(), Start, End, Color, false, -1., 0, 2.f);
 }
 
+void FWeaponFlightRecorder::Dump(const FString& Label) const
+{
+	const uint32 Count = FMath::Min(Head, Capacity);
+	UE_LOG(LogTemp, Warning, TEXT("%s: last %d weapon commands"), *Label, Count);
+
+	for (uint32 i = Head - Count; i != Head; ++i)
+	{
+		const auto& Event = Events[i & (Capacity - 1)];
+		UE_LOG(LogTemp, Warning, TEXT("  %.3f %s > %s > %s (Clip:%d Pool:%d)"), Event.Time,
+			*EWeaponModesStr(Event.OldMode), *EWeaponCommandsStr(Event.Cmd), *EWeaponModesStr(Event.NewMode),
+			Event.AmmoInClip, Event.AmmoInPool);
+	}
+}
+
+void UWeaponReceiverComponent::DumpFlightRecorder() const
+{
+	const FString Role = HasAuthority() ? "Auth" : IsPredicting() ? "Auto" : "Sim";
+	FlightRecorder.Dump(Role + " " + (Delegate ? Delegate->GetWeaponName() : GetName()));
+}
+
 void UWeaponReceiverComponent::LogMsgWithRole(FString message)
 {
 	FString m = GetRoleText() + " " + Delegate->GetWeaponName() + ": " + message;
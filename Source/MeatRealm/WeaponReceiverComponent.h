@@ -2,6 +2,9 @@
 
 #include "CoreMinimal.h"
 #include "Components/ActorComponent.h"
+#include "Engine/NetSerialization.h"
+#include "WeaponDefinition.h"
+#include "TimedActionComponent.h"
 
 #include "WeaponReceiverComponent.generated.h"
 
@@ -63,6 +66,118 @@ public:
 	}
 };
 
+// Player inputs to the receiver. Numbered on the client so the server can acknowledge them.
+UENUM()
+enum class EWeaponInput : uint8
+{
+	Draw, Holster,
+	PullTrigger, ReleaseTrigger,
+	Reload,
+	AdsPressed, AdsReleased,
+};
+
+struct FWeaponPendingInput
+{
+	uint16 Seq;
+	EWeaponInput Input;
+};
+
+// The owner's recent inputs, sent unreliably and repeated until acked so a lost packet is covered by the next one
+USTRUCT()
+struct FWeaponInputPacket
+{
+	GENERATED_BODY()
+
+	static const int32 MaxInputs = 8;
+
+	// Inputs that are held rather than pressed
+	static const uint8 HeldTrigger = 1 << 0;
+	static const uint8 HeldAds = 1 << 1;
+
+	// Seq of the last entry in Inputs. The rest count back from it.
+	uint16 LastSeq = 0;
+
+	// Trigger/ADS as the client last had them. Lets the server recover if more than MaxInputs went missing.
+	uint8 HeldBits = 0;
+
+	// Oldest first
+	TArray<EWeaponInput, TInlineAllocator<MaxInputs>> Inputs;
+
+	uint16 GetFirstSeq() const { return LastSeq - Inputs.Num() + 1; }
+
+	bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess);
+};
+
+template<>
+struct TStructOpsTypeTraits<FWeaponInputPacket> : public TStructOpsTypeTraitsBase2<FWeaponInputPacket>
+{
+	enum
+	{
+		WithNetSerializer = true,
+	};
+};
+
+// What everyone else sees of a weapon. Ammo and burst only go to the owner, in FWeaponAck.
+USTRUCT()
+struct FWeaponPublicState
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+		EWeaponModes Mode = EWeaponModes::UnEquipped;
+
+	UPROPERTY()
+		bool IsAdsing = false;
+
+	// Server world time the reload began. Clients work out the progress from it. Only sent while reloading.
+	UPROPERTY()
+		float ReloadStartTime = 0;
+
+	bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess);
+};
+
+template<>
+struct TStructOpsTypeTraits<FWeaponPublicState> : public TStructOpsTypeTraitsBase2<FWeaponPublicState>
+{
+	enum
+	{
+		WithNetSerializer = true,
+	};
+};
+
+// What the server last knew about the receiver, sent to the owning client only
+USTRUCT()
+struct FWeaponAck
+{
+	GENERATED_BODY()
+
+	// Newest input the server has processed
+	UPROPERTY()
+		uint16 InputSeq = 0;
+
+	// Total shots fired by the server, used to work out which of our predicted shots it hasn't seen yet
+	UPROPERTY()
+		uint16 ShotCount = 0;
+
+	// ReloadProgress isn't sent, it's derived from ReloadStartTime
+	UPROPERTY()
+		FWeaponState State;
+
+	UPROPERTY()
+		float ReloadStartTime = 0;
+
+	bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess);
+};
+
+template<>
+struct TStructOpsTypeTraits<FWeaponAck> : public TStructOpsTypeTraitsBase2<FWeaponAck>
+{
+	enum
+	{
+		WithNetSerializer = true,
+	};
+};
+
 USTRUCT()
 struct FWeaponInputState
 {
@@ -83,21 +198,54 @@ struct FWeaponInputState
 	}
 };
 
+// Everything needed to rebuild a trigger pull's pellets. Sent to clients in place of the projectiles themselves.
+USTRUCT()
+struct FShotEvent
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+		FVector_NetQuantize Muzzle;
+
+	// Barrel yaw, compressed to 16 bits. The server shoots with the compressed value so clients match exactly.
+	UPROPERTY()
+		uint16 Heading = 0;
+
+	// Seeds the spread for this pull
+	UPROPERTY()
+		uint16 Seed = 0;
+
+	// Server world time the shot was fired
+	UPROPERTY()
+		float ServerTime = 0;
+
+	UPROPERTY()
+		bool bIsAdsing = false;
+
+	void SetHeadingAngle(float Radians) { Heading = FRotator::CompressAxisToShort(FMath::RadiansToDegrees(Radians)); }
+	float GetHeadingAngle() const { return FMath::DegreesToRadians(FRotator::DecompressAxisFromShort(Heading)); }
+};
+
+// Pellet directions for one shot. Inline so even a shotgun blast stays off the heap.
+typedef TArray<FVector, TInlineAllocator<16>> FShotPattern;
+
 class IReceiverComponentDelegate
 {
 public:
 	virtual ~IReceiverComponentDelegate() = default;
-	virtual void ShotFired() = 0;
+	virtual void ShotFired(const FShotEvent& Shot) = 0;
 	virtual void AmmoInClipChanged(int AmmoInClip) = 0;
 	virtual void AmmoInPoolChanged(int AmmoInPool) = 0;
 	virtual void InReloadingChanged(bool IsReloading) = 0;
 	virtual void OnReloadProgressChanged(float ReloadProgress) = 0;
-	virtual bool SpawnAProjectile(const FVector& Direction) = 0;
+	// Age is how long ago (seconds) the shot was due. Advance the projectile to where it would be now.
+	virtual bool SpawnAProjectile(const FVector& Direction, float Age) = 0;
 	virtual FVector GetBarrelDirection() = 0;
 	virtual FVector GetBarrelLocation() = 0;
 	virtual AActor* GetOwningPawn() = 0;
 	virtual FString GetWeaponName() = 0;
 	virtual float GetDrawDuration() = 0;
+	virtual bool IsLocallyPredicted() = 0;
 };
 
 
@@ -129,6 +277,41 @@ inline FString EWeaponModesStr(const EWeaponModes Mode)
 }
 
 
+// One state machine command, as it happened
+struct FWeaponFlightEvent
+{
+	float Time;
+	EWeaponModes OldMode;
+	EWeaponCommands Cmd;
+	EWeaponModes NewMode;
+	int16 AmmoInClip;
+	int16 AmmoInPool;
+};
+
+// Fixed size ring of the receiver's recent commands. Cheap enough to always record, only turned into text when dumped.
+struct FWeaponFlightRecorder
+{
+	static const uint32 Capacity = 64; // Power of 2
+
+	void Record(float Time, EWeaponModes OldMode, EWeaponCommands Cmd, EWeaponModes NewMode, int AmmoInClip, int AmmoInPool)
+	{
+		auto& Event = Events[Head++ & (Capacity - 1)];
+		Event.Time = Time;
+		Event.OldMode = OldMode;
+		Event.Cmd = Cmd;
+		Event.NewMode = NewMode;
+		Event.AmmoInClip = AmmoInClip;
+		Event.AmmoInPool = AmmoInPool;
+	}
+
+	// Oldest first
+	void Dump(const FString& Label) const;
+
+private:
+	FWeaponFlightEvent Events[Capacity];
+	uint32 Head = 0;
+};
+
 
 UCLASS( ClassGroup=(Custom), meta=(BlueprintSpawnableComponent) )
 class MEATREALM_API UWeaponReceiverComponent : public UActorComponent
@@ -137,6 +320,7 @@ class MEATREALM_API UWeaponReceiverComponent : public UActorComponent
 
 public:
 	// Configure the gun
+	// Legacy. Only read off the class defaults to build a shared UWeaponDefinition for weapons without one. Use the definition.
 
 	UPROPERTY(EditAnywhere)
 		float ShotsPerSecond = 1.0f;
@@ -186,13 +370,6 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadOnly)
 		bool CanReceiveAmmo = true;
 
-protected:
-
-	UPROPERTY(BlueprintReadOnly, Replicated)
-		FWeaponState WeaponState {};
-
-private:
-
 	UPROPERTY(EditAnywhere)
 		float AdsLineLength = 1500; // cm
 
@@ -205,21 +382,74 @@ private:
 	UPROPERTY(EditAnywhere)
 		FColor EnemyAdsLineColor = FColor{ 255,170,75 };
 
+protected:
+
+	// Not replicated. Others get PublicState, the owner gets Ack.
+	UPROPERTY(BlueprintReadOnly)
+		FWeaponState WeaponState {};
+
+private:
+
+	// How long (seconds) the predicted state may disagree with the server before we snap to the server
+	UPROPERTY(EditAnywhere)
+		float CorrectionGrace = 0.25f;
+
+	UPROPERTY(ReplicatedUsing = OnRep_PublicState)
+		FWeaponPublicState PublicState;
+
+	UPROPERTY(ReplicatedUsing = OnRep_Ack)
+		FWeaponAck Ack;
+
+	// Shared by server and owner so predicted spread matches the real thing
+	UPROPERTY(Replicated)
+		int32 SpreadSeed = 0;
+
+	uint16 ShotCount = 0;
+
+	/// Prediction [Autonomous]
+	uint16 LastInputSeq = 0;
+	TArray<FWeaponPendingInput> PendingInputs;
+	uint8 HeldInputs = 0; // FWeaponInputPacket::HeldXXX bits. Kept on both sides.
+	FTimerHandle CorrectionTimerHandle;
+	bool bHasReceivedAck = false;
+
+	// Shared config. Set by the weapon before BeginPlay.
+	UPROPERTY()
+		UWeaponDefinition* Def = nullptr;
+
+	// Starting ammo for this copy only, e.g. a pickup that gives a partly used weapon. -1 uses the definition.
+	int ClipGivenOverride = -1;
+	int PoolGivenOverride = -1;
+
 	FWeaponInputState InputState{};
 	IReceiverComponentDelegate* Delegate = nullptr;
 
 	bool bIsMidReload;
-	FDateTime ReloadStartTime;
-	FTimerHandle BusyTimerHandle;
+	float ReloadStartTime = 0; // Server world time
+	FTimedActionHandle BusyAction; // Equipping or reloading
 	bool bIsBusy;
 
 
 	TArray<float> ShotTimes{};
 
+	// World time the next shot is due. Advanced by exactly one shot interval per shot.
+	float NextShotTime = -1;
+
+	// World time of the last tick that fired, for checking the burst against the schedule
+	float LastShotTickTime = 0;
+
+	FWeaponFlightRecorder FlightRecorder;
+
+	// Whether we're counted as active in the receiver stats
+	bool bIsTickActive = false;
+
 
 public:	
 	UWeaponReceiverComponent();
 	void SetDelegate(IReceiverComponentDelegate* TheDelegate) { Delegate = TheDelegate; }
+	void SetDefinition(UWeaponDefinition* Definition) { Def = Definition; }
+	const UWeaponDefinition* GetDefinition() const { return Def; }
+	void OverrideAmmoGiven(int AmmoInClip, int AmmoInPool);
 	void DrawWeapon();
 	void HolsterWeapon();
 	void PullTrigger();
@@ -227,40 +457,84 @@ public:
 	void Reload();
 	void AdsPressed();
 	void AdsReleased();
+
+	// [Autonomous] Number and queue an input for the server, applying it straight away if we're predicting
+	void PredictInput(EWeaponInput Input);
+	// [Autonomous] Fill a packet with the newest inputs the server hasn't acked. False when there's nothing to send.
+	bool BuildInputPacket(FWeaponInputPacket& OutPacket) const;
+	// [Server] Apply any inputs in the packet we haven't seen before. Safe to call with repeats.
+	void ServerApplyInputPacket(const FWeaponInputPacket& Packet);
+	static bool IsValidInputPacket(const FWeaponInputPacket& Packet);
+
 	bool CanGiveAmmo();
 	bool TryGiveAmmo();
 	bool IsEquipping() const { return WeaponState.Mode == EWeaponModes::Equipping; }
 	void CancelAnyReload();
 	bool IsReloading() const { return WeaponState.Mode == EWeaponModes::Reloading; }
 
-	FWeaponState GetState() const { return WeaponState; }
+	FWeaponState GetState() const;
+
+	// Log the recent state machine history. See UMeatRealmGameInstance::DumpWeaponRecorders.
+	void DumpFlightRecorder() const;
+
+	// Pellet directions for a shot. Deterministic for a given heading, ADS state and random stream.
+	void CalcShotPattern(float BarrelAngle, bool bIsAdsing, FRandomStream& Random, FShotPattern& OutShots) const;
+
 protected:
 
 	UFUNCTION(BlueprintCallable)
-		float GetReloadTimeRemaining() const { return (1 - WeaponState.ReloadProgress) * GetReloadTime(); }
+		float GetReloadTimeRemaining() const { return (1 - GetReloadProgress()) * GetReloadTime(); }
 
 private:
 	bool HasAuthority() const { return GetOwnerRole() == ROLE_Authority; }
+	bool IsPredicting() const { return !HasAuthority() && Delegate && Delegate->IsLocallyPredicted(); }
+	// Runs the state machine. The server always does, the owning client does when predicting.
+	bool IsSimulating() const { return HasAuthority() || IsPredicting(); }
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+	virtual void PreReplication(IRepChangedPropertyTracker& ChangedPropertyTracker) override;
 	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
 
 
+	// Only tick while there's something to do. Called whenever input or state changes.
+	void UpdateTickEnabled();
+	bool NeedsTick() const;
+
+	UFUNCTION()
+		void OnRep_PublicState();
+
+	/// Prediction
+	void ApplyInput(EWeaponInput Input);
+	void TrackHeldInput(EWeaponInput Input);
+
+	UFUNCTION()
+		void OnRep_Ack();
+
+	bool IsInAgreementWithServer() const;
+	void CheckPrediction();
+	void SnapToServer();
+
 	// All the states!
 	bool TickIdle(float DT);
 	//bool TickUnEquipped(float DeltaTime);
 	bool TickFiring(float DT);
-	void FireEnd();
+	void FireShot(float ShotTime, float Age);
 	bool TickReloading(float DT);
 	void ReloadEnd();
 	void DoTransitionAction(const EWeaponModes OldMode, const EWeaponModes NewMode, FWeaponState& NewState);
 	bool ChangeState(EWeaponCommands Cmd, FWeaponState& WeapState);
 	void EquipEnd();
 
-	float GetReloadTime() const { return ReloadTime; }
-	float GetAdsSpread() const { return  AdsSpread; }
-	float GetHipfireSpread() const { return HipfireSpread; }
+	float GetReloadTime() const { return Def->ReloadTime; }
+	float GetReloadProgress() const;
+	float GetServerTime() const;
+	void ResumeReload();
+	FTimedAction StartBusy(float Duration, void(UWeaponReceiverComponent::*OnDone)());
+	void ScheduleBusy(const FTimedAction& Action, void(UWeaponReceiverComponent::*OnDone)());
+	void CancelBusy();
+	float GetAdsSpread() const { return Def->AdsSpread; }
+	float GetHipfireSpread() const { return Def->HipfireSpread; }
 
-	TArray<FVector> CalcShotPattern() const;
 	bool CanReload() const;
 	bool NeedsReload() const;
 	void DrawAdsLine(const FColor& Color, float LineLength) const;